@@ -0,0 +1,247 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		acia.cpp
+//		Purpose:	MC6850 ACIA (cassette / serial port) at $F000, connected to host files, pipes or a pseudo terminal
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef LINUX
+#include <poll.h>
+#include <termios.h>
+#endif
+#include "sys_processor.h"
+#include "acia.h"
+
+static int inputFile = -1;															// Received bytes come from here
+static int outputFile = -1;															// Transmitted bytes go here
+static int isEnabled = 0;
+static int baudRate = 300;															// 0 is as fast as the guest can go
+static int ACIAReadFile(BYTE8 *buffer,int size);
+static ACIASOURCE source = ACIAReadFile;											// Where received bytes come from
+static void ACIAWriteFile(BYTE8 data);
+static ACIASINK sink = ACIAWriteFile;												// Where transmitted bytes go
+
+static BYTE8 control = 0;															// Control register
+static BYTE8 isReceived = 0;														// Receive data register full
+static BYTE8 rxData;																// Receive data register
+static LONG32 rxTime,txTime;														// Clock when next in/out is possible
+
+static BYTE8 inBuffer[4096];														// Host side buffers
+static int inCount = 0,inPosition = 0;
+static BYTE8 outBuffer[4096];
+static int outCount = 0;
+
+// *******************************************************************************************************************************
+//		Cycles to send or receive one character : a start bit, the data bits, parity and stop bits set by the word
+//		select bits 2-4 of control. The counter divide bits are ignored, the baud rate is set by the host.
+// *******************************************************************************************************************************
+
+static LONG32 ACIACharacterTime(void) {
+	static const BYTE8 frameBits[8] = { 11,11,10,10,11,10,11,11 };
+	if (baudRate == 0) return 0;
+	return (LONG32)((long long)ACIA_CPU_CLOCK * frameBits[(control >> 2) & 7] / baudRate);
+}
+
+static int ACIAIsDue(LONG32 time) {													// Clock has reached time (wraps)
+	return (LONG32)(CPUGetClock() - time) < 0x80000000;
+}
+
+static BYTE8 ACIAMask(int data) {													// 7 bit word formats lose bit 7
+	return (control & 0x10) ? data : (data & 0x7F);
+}
+
+// *******************************************************************************************************************************
+//		Output is buffered and written once a frame, or when the buffer fills. Writes wait, so a pipe or terminal that
+//		is not being read holds up the emulation much as a real line would.
+// *******************************************************************************************************************************
+
+static void ACIAFlush(void) {
+	int done = 0;
+	while (done < outCount && outputFile >= 0) {
+		int n = write(outputFile,outBuffer+done,outCount-done);
+		if (n <= 0) break;
+		done += n;
+	}
+	outCount = 0;
+}
+
+static void ACIAWriteFile(BYTE8 data) {												// The default sink
+	if (outCount == (int)sizeof(outBuffer)) ACIAFlush();
+	outBuffer[outCount++] = data;
+}
+
+// *******************************************************************************************************************************
+//		Receiving. The next byte arrives one character time after the last was read, so the guest is never overrun
+//		however slowly it reads. Nothing waiting on the host is looked for again ACIA_POLL cycles later. A source
+//		returns how many bytes it put in the buffer, 0 if it has none yet.
+// *******************************************************************************************************************************
+
+static int ACIAReadFile(BYTE8 *buffer,int size) {									// The default source
+	if (inputFile < 0) return 0;
+	#ifdef LINUX																	// Pipes and terminals may have nothing yet
+	struct pollfd pending = { inputFile,POLLIN,0 };
+	if (poll(&pending,1,0) <= 0 || (pending.revents & POLLIN) == 0) return 0;
+	#endif
+	int n = read(inputFile,buffer,size);
+	return (n < 0) ? 0 : n;
+}
+
+static int ACIAHostByte(void) {
+	if (inPosition == inCount) {
+		int n = (*source)(inBuffer,sizeof(inBuffer));
+		if (n <= 0) return -1;
+		inCount = n;inPosition = 0;
+	}
+	return inBuffer[inPosition++];
+}
+
+static void ACIAReceive(void) {
+	if (isReceived || !ACIAIsDue(rxTime)) return;
+	int ch = ACIAHostByte();
+	if (ch < 0) {
+		rxTime = CPUGetClock() + ACIA_POLL;
+		return;
+	}
+	rxData = ACIAMask(ch);
+	isReceived = 1;
+}
+
+// *******************************************************************************************************************************
+//		Status register, IRQ line. ACIAPeek() is the registers as the host (debugger, traps) sees them, nothing is
+//		received or emptied by looking.
+// *******************************************************************************************************************************
+
+BYTE8 ACIAPeek(WORD16 address) {
+	if ((address & 1) != 0) return rxData;
+	BYTE8 status = isReceived ? ACIA_RDRF : 0;
+	if (ACIAIsDue(txTime)) status |= ACIA_TDRE;
+	if (((control & 0x80) && (status & ACIA_RDRF)) ||								// Receive interrupt enabled
+			((control & 0x60) == 0x20 && (status & ACIA_TDRE))) status |= ACIA_IRQ;	// Transmit interrupt enabled
+	return status;
+}
+
+static BYTE8 ACIAStatus(void) {
+	ACIAReceive();
+	return ACIAPeek(ACIA_BASE);
+}
+
+static int ACIAInterrupt(void) {
+	return (ACIAStatus() & ACIA_IRQ) != 0;
+}
+
+// *******************************************************************************************************************************
+//											Guest access to the registers
+// *******************************************************************************************************************************
+
+BYTE8 ACIARead(WORD16 address) {
+	if ((address & 1) == 0) return ACIAStatus();
+	if (isReceived) {																// Reading the data empties it
+		isReceived = 0;
+		rxTime = CPUGetClock() + ACIACharacterTime();
+	}
+	return rxData;
+}
+
+void ACIAWrite(WORD16 address,BYTE8 data) {
+	if ((address & 1) == 0) {
+		control = data;
+		if ((data & 3) == 3) {														// Master reset
+			isReceived = 0;
+			rxTime = txTime = CPUGetClock();
+		}
+		return;
+	}
+	(*sink)(ACIAMask(data));
+	txTime = CPUGetClock() + ACIACharacterTime();
+}
+
+// *******************************************************************************************************************************
+//		Connect to the host. "-" is stdin or stdout. Any of these turns the ACIA on, otherwise $F000 is left as it was.
+// *******************************************************************************************************************************
+
+static void ACIAStart(void) {
+	isEnabled = 1;
+	rxTime = txTime = CPUGetClock();
+}
+
+int ACIAOpenInput(const char *fileName) {
+	inputFile = (strcmp(fileName,"-") == 0) ? STDIN_FILENO : open(fileName,O_RDONLY);
+	if (inputFile < 0) { perror(fileName);return 0; }
+	ACIAStart();
+	return 1;
+}
+
+int ACIAOpenOutput(const char *fileName) {
+	outputFile = (strcmp(fileName,"-") == 0) ? STDOUT_FILENO : open(fileName,O_WRONLY|O_CREAT|O_TRUNC,0644);
+	if (outputFile < 0) { perror(fileName);return 0; }
+	ACIAStart();
+	return 1;
+}
+
+#ifdef LINUX
+int ACIAOpenTerminal(void) {														// Both ends on a new pty
+	int master = posix_openpt(O_RDWR|O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) { perror("pty");return 0; }
+	struct termios raw;																// No echo or line editing.
+	if (tcgetattr(master,&raw) == 0) {
+		cfmakeraw(&raw);
+		tcsetattr(master,TCSANOW,&raw);
+	}
+	fprintf(stderr,"ACIA connected to %s\n",ptsname(master));
+	inputFile = outputFile = master;
+	ACIAStart();
+	return 1;
+}
+#else
+int ACIAOpenTerminal(void) {
+	printf("Pseudo terminals are not supported on this platform.\n");
+	return 0;
+}
+#endif
+
+void ACIASetSource(ACIASOURCE newSource) {										// Something else, e.g. a tape
+	source = newSource;
+	inCount = inPosition = 0;
+	ACIAStart();
+}
+
+void ACIASetSink(ACIASINK newSink) {
+	sink = newSink;
+	ACIAStart();
+}
+
+void ACIASetBaudRate(int baud) {
+	baudRate = (baud < 0) ? 0 : baud;
+}
+
+void ACIAEnableInterrupt(void) {
+	CPUSetInterruptSource(ACIAInterrupt);
+}
+
+int ACIAIsEnabled(void) {
+	return isEnabled;
+}
+
+// *******************************************************************************************************************************
+//										Once a frame, and when finishing
+// *******************************************************************************************************************************
+
+void ACIASync(void) {
+	if (outCount != 0) ACIAFlush();
+}
+
+void ACIAClose(void) {
+	ACIAFlush();
+	if (inputFile > STDERR_FILENO) close(inputFile);
+	if (outputFile > STDERR_FILENO && outputFile != inputFile) close(outputFile);
+	inputFile = outputFile = -1;
+}
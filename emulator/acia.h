@@ -0,0 +1,40 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		acia.h
+//		Purpose:	MC6850 ACIA (cassette / serial port) at $F000 (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _ACIA_H
+#define _ACIA_H
+
+#define ACIA_BASE 		(0xF000)													// Control/Status, Data at +1
+#define ACIA_CPU_CLOCK 	(1000000)													// Cycles per second, as sys_processor.cpp
+#define ACIA_POLL 		(1000)														// Cycles between looks for input
+
+#define ACIA_RDRF 		(0x01)														// Status bits
+#define ACIA_TDRE 		(0x02)
+#define ACIA_IRQ 		(0x80)
+
+typedef int (*ACIASOURCE)(BYTE8 *buffer,int size);
+typedef void (*ACIASINK)(BYTE8 data);
+
+int  ACIAOpenInput(const char *fileName);
+int  ACIAOpenOutput(const char *fileName);
+int  ACIAOpenTerminal(void);
+void ACIASetSource(ACIASOURCE source);
+void ACIASetSink(ACIASINK sink);
+void ACIASetBaudRate(int baud);
+void ACIAEnableInterrupt(void);
+int  ACIAIsEnabled(void);
+BYTE8 ACIARead(WORD16 address);
+BYTE8 ACIAPeek(WORD16 address);
+void ACIAWrite(WORD16 address,BYTE8 data);
+void ACIASync(void);
+void ACIAClose(void);
+
+#endif
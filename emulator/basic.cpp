@@ -0,0 +1,294 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		basic.cpp
+//		Purpose:	Host side tokenising of UK101 (Microsoft 6502) BASIC programs
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "sys_processor.h"
+#include "basic.h"
+
+static BYTE8 *program = NULL;														// Program waiting to be put in RAM.
+static int programSize = 0;
+
+// *******************************************************************************************************************************
+//
+//		Tokenise the text of a line (after the line number) the way the ROM does (CRUNCH at $A3A6), so the result is
+//		the same as typing it. Spaces are kept, but ignored inside a keyword. Keywords are matched in table order, from
+//		the table in the ROM, ignoring case. Strings, the rest of a REM and DATA up to a ':' are copied as they are,
+//		lower case included, everything else is made capitals. '?' is PRINT.
+//		Returns the length, including the terminating zero.
+//
+// *******************************************************************************************************************************
+
+int BASTokenise(const char *text,BYTE8 *tokens) {
+	int n = 0,inData = 0;
+	while (*text != '\0' && n < BAS_MAXLINE-1) {
+		int ch = toupper(*text);													// Shift Lock is always down.
+		if (ch == '"') {															// String, copy to the closing quote.
+			tokens[n++] = *text++;
+			while (*text != '\0' && *text != '"' && n < BAS_MAXLINE-1) tokens[n++] = *text++;
+			if (*text == '"' && n < BAS_MAXLINE-1) tokens[n++] = *text++;
+			continue;
+		}
+		if (inData) {																// DATA as it is.
+			tokens[n++] = *text++;
+		} else if (ch == ' ' || (ch >= '0' && ch < '<')) {
+			tokens[n++] = ch;text++;
+		} else if (ch == '?') {
+			tokens[n++] = 0x97;text++;												// PRINT
+		} else {
+			int token = BAS_FIRSTTOKEN,entry = BAS_KEYWORDS,length = 0;
+			while (length == 0 && CPUReadMemory(entry) != 0) {						// Try each keyword
+				int i = 0,p = 0;
+				while (1) {
+					while (text[i] == ' ' && i > 0) i++;							// Spaces don't count
+					int k = CPUReadMemory(entry+p);
+					if (toupper(text[i]) != (k & 0x7F)) break;
+					i++;p++;
+					if (k & 0x80) { length = i;break; }								// Whole keyword matched.
+				}
+				if (length == 0) {													// Next keyword.
+					while ((CPUReadMemory(entry) & 0x80) == 0) entry++;
+					entry++;token++;
+				}
+			}
+			if (length != 0) {
+				tokens[n++] = token;text += length;
+			} else {
+				tokens[n++] = ch;text++;
+			}
+		}
+		int last = tokens[n-1];
+		if (last == ':') inData = 0;												// End of DATA
+		if (last == 0x83) inData = 1;												// DATA
+		if (last == 0x8E) {															// REM, rest as it is.
+			while (*text != '\0' && n < BAS_MAXLINE-1) tokens[n++] = *text++;
+		}
+	}
+	tokens[n++] = 0;
+	return n;
+}
+
+// *******************************************************************************************************************************
+//		Read a program, tokenise it and build the line chain. Lines are sorted, a repeated line number replaces the
+//		earlier one and a number on its own deletes it. It is put in RAM when BASIC is first ready for input.
+// *******************************************************************************************************************************
+
+typedef struct __BASLINE {
+	int number,order;
+	int size;
+	BYTE8 tokens[BAS_MAXLINE];
+} BASLINE;
+
+static int BASCompareLines(const void *a,const void *b) {
+	const BASLINE *l1 = (const BASLINE *)a,*l2 = (const BASLINE *)b;
+	if (l1->number != l2->number) return l1->number - l2->number;
+	return l1->order - l2->order;
+}
+
+static int BASInjectTrap(CPUSTATUS *);
+
+static int BASBuild(const char *fileName) {
+	FILE *f = fopen(fileName,"r");
+	if (f == NULL) { perror(fileName);return 0; }
+	int count = 0,max = 256;
+	BASLINE *lines = (BASLINE *)malloc(max * sizeof(BASLINE));
+	char buffer[1024];
+	while (fgets(buffer,sizeof(buffer),f) != NULL) {
+		char *p = buffer + strlen(buffer);
+		while (p > buffer && (p[-1] == '\n' || p[-1] == '\r')) *--p = '\0';
+		p = buffer;
+		while (*p == ' ') p++;
+		if (!isdigit(*p)) continue;													// Not a program line.
+		if (count == max) {
+			max = max * 2;
+			lines = (BASLINE *)realloc(lines,max * sizeof(BASLINE));
+		}
+		BASLINE *l = &lines[count];
+		l->number = 0;
+		while (isdigit(*p) || *p == ' ') {											// Line number, spaces skipped
+			if (*p != ' ') l->number = l->number * 10 + *p - '0';
+			p++;
+		}
+		if (l->number > 63999) {
+			printf("%s: line %d is too big.\n",fileName,l->number);
+			fclose(f);free(lines);return 0;
+		}
+		l->order = count++;
+		l->size = (*p == '\0') ? 0 : BASTokenise(p,l->tokens);
+	}
+	fclose(f);
+	qsort(lines,count,sizeof(BASLINE),BASCompareLines);
+
+	free(program);																	// Build the chain, with links as offsets.
+	program = (BYTE8 *)malloc(count * (BAS_MAXLINE+4) + 2);
+	programSize = 0;
+	for (int i = 0;i < count;i++) {
+		if (i+1 < count && lines[i+1].number == lines[i].number) continue;			// Replaced by a later one.
+		if (lines[i].size == 0) continue;											// Deleted.
+		int next = programSize + 4 + lines[i].size;
+		program[programSize] = next & 0xFF;program[programSize+1] = next >> 8;
+		program[programSize+2] = lines[i].number & 0xFF;program[programSize+3] = lines[i].number >> 8;
+		memcpy(program+programSize+4,lines[i].tokens,lines[i].size);
+		programSize = next;
+	}
+	program[programSize++] = 0;program[programSize++] = 0;							// End of program.
+	free(lines);
+	return 1;
+}
+
+int BASLoad(const char *fileName) {
+	if (!BASBuild(fileName)) return 0;
+	CPUSetTrap(BAS_READY,BASInjectTrap);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//		Copy the program to TXTTAB, relocating the links, then set the pointers as NEW and CLEAR would, variables
+//		starting 3 bytes after the final zero link (as the ROM does). Returns zero if it does not fit.
+// *******************************************************************************************************************************
+
+#define PEEKW(a) 	(CPUReadMemory(a) + (CPUReadMemory((a)+1) << 8))
+#define POKEW(a,d) 	{ CPUWriteMemory(a,(d) & 0xFF);CPUWriteMemory((a)+1,((d) >> 8) & 0xFF); }
+
+static int BASInstall(void) {
+	int start = PEEKW(BAS_TXTTAB);
+	int varStart = start + programSize + 1;
+	if (varStart >= PEEKW(BAS_MEMSIZ)) {
+		printf("Program too large for memory.\n");
+		return 0;
+	}
+	for (int i = 0;i < programSize;i++) CPUWriteMemory(start+i,program[i]);
+	int p = start;																	// Relocate the links
+	while (PEEKW(p) != 0) {
+		int next = PEEKW(p) + start;
+		POKEW(p,next);
+		p = next;
+	}
+	POKEW(BAS_VARTAB,varStart);
+	POKEW(BAS_ARYTAB,varStart);
+	POKEW(BAS_STREND,varStart);
+	POKEW(BAS_FRETOP,PEEKW(BAS_MEMSIZ));
+	return 1;
+}
+
+static int BASInjectTrap(CPUSTATUS *) {												// Once, when BASIC is ready.
+	CPUSetTrap(BAS_READY,NULL);
+	BASInstall();
+	return CPUTRAP_CONTINUE;
+}
+
+// *******************************************************************************************************************************
+//		Replace the program in RAM now, when BASIC is already running. Returns 0 if it couldn't be read, -1 if it
+//		was too big.
+// *******************************************************************************************************************************
+
+int BASLoadNow(const char *fileName) {
+	if (!BASBuild(fileName)) return 0;
+	return BASInstall() ? 1 : -1;
+}
+
+// *******************************************************************************************************************************
+//		Expand the program in a 64k memory image (which has the ROM in it, for the keywords) into text, one line per
+//		program line, as LIST would but without the screen width. A broken chain ends the listing. Returns the length,
+//		or -1 if it did not fit.
+// *******************************************************************************************************************************
+
+int BASDetokenise(const BYTE8 *memory,char *text,int size) {
+	const BYTE8 *keywords[128];														// Start of each keyword
+	int keywordCount = 0,p = BAS_KEYWORDS;
+	while (memory[p] != 0 && keywordCount < 128 && p < 0xFFFF) {
+		keywords[keywordCount++] = memory+p;
+		while ((memory[p] & 0x80) == 0 && p < 0xFFFF) p++;
+		p++;
+	}
+	int n = 0;
+	int line = memory[BAS_TXTTAB] + (memory[BAS_TXTTAB+1] << 8);
+	while (line < 0xFFFB && (memory[line] | memory[line+1]) != 0) {
+		int next = memory[line] + (memory[line+1] << 8);
+		if (next <= line) break;													// Chain must go forwards.
+		if (n + 8 + BAS_MAXLINE * 8 > size) return -1;								// Room for the worst case.
+		n += sprintf(text+n,"%d ",memory[line+2] + (memory[line+3] << 8));
+		for (int i = line+4;i < 0xFFFF && i < line+4+BAS_MAXLINE && memory[i] != 0;i++) {
+			int c = memory[i];
+			if (c >= BAS_FIRSTTOKEN && c - BAS_FIRSTTOKEN < keywordCount) {			// Keyword
+				const BYTE8 *k = keywords[c - BAS_FIRSTTOKEN];
+				do { text[n++] = *k & 0x7F; } while ((*k++ & 0x80) == 0);
+			} else {
+				text[n++] = c;
+			}
+		}
+		text[n++] = '\n';
+		line = next;
+	}
+	text[n] = '\0';
+	return n;
+}
+
+// *******************************************************************************************************************************
+//										Write the listing of a memory image to a file
+// *******************************************************************************************************************************
+
+static int BASWriteListing(const BYTE8 *memory,const char *fileName) {
+	static char text[0x10000 * 8];
+	int n = BASDetokenise(memory,text,sizeof(text));
+	if (n < 0) { printf("Program too long to list.\n");return 0; }
+	FILE *f = (strcmp(fileName,"-") == 0) ? stdout : fopen(fileName,"w");
+	if (f == NULL) { perror(fileName);return 0; }
+	fwrite(text,1,n,f);
+	if (f != stdout) fclose(f);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//						List the program in a memory image file, e.g. memory.dump, which is 64k from $0000
+// *******************************************************************************************************************************
+
+int BASListImage(const char *imageFile,const char *fileName) {
+	static BYTE8 memory[0x10000];
+	FILE *f = fopen(imageFile,"rb");
+	if (f == NULL) { perror(imageFile);return 0; }
+	memset(memory,0,sizeof(memory));
+	int size = fread(memory,1,sizeof(memory),f);
+	fclose(f);
+	if (size < BAS_KEYWORDS + 0x100) {												// Needs to have the ROM in it.
+		printf("%s is not a memory image.\n",imageFile);
+		return 0;
+	}
+	return BASWriteListing(memory,fileName);
+}
+
+// *******************************************************************************************************************************
+//										List the program in the running machine on exit
+// *******************************************************************************************************************************
+
+static const char *listFile = NULL;
+
+void BASListOnExit(const char *fileName) {
+	listFile = fileName;
+}
+
+void BASEnd(void) {
+	if (listFile == NULL) return;
+	BASSave(listFile);
+	listFile = NULL;
+}
+
+// *******************************************************************************************************************************
+//						Write the program in the running machine as text, which BASLoad() reads back
+// *******************************************************************************************************************************
+
+int BASSave(const char *fileName) {
+	static BYTE8 memory[0x10000];
+	for (int i = 0;i < 0x10000;i++) memory[i] = CPUReadMemory(i);
+	return BASWriteListing(memory,fileName);
+}
@@ -0,0 +1,44 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		basic.h
+//		Purpose:	Host side tokenising of UK101 (Microsoft 6502) BASIC programs (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _BASIC_H
+#define _BASIC_H
+
+#define BAS_KEYWORDS 	(0xA084)													// Keyword table, last character has bit 7 set
+#define BAS_FIRSTTOKEN 	(0x80)														// Token of the first keyword (END)
+#define BAS_READY 		(0xA27D)													// Main loop, about to input a line.
+
+#define BAS_TXTTAB 		(0x79)														// Zero page : start of program
+#define BAS_VARTAB 		(0x7B)														// Start of variables
+#define BAS_ARYTAB 		(0x7D)														// Start of arrays
+#define BAS_STREND 		(0x7F)														// End of arrays
+#define BAS_FRETOP 		(0x81)														// Bottom of strings
+#define BAS_MEMSIZ 		(0x85)														// Top of memory
+#define BAS_CURLIN 		(0x87)														// Line running, high byte $FF if direct
+#define BAS_TXTPTR 		(0xC3)														// Next character (in CHRGET)
+
+#define BAS_ERROR 		(0xA24E)													// Report error X and stop
+#define BAS_ERR_SYNTAX 	(2)															// Offsets of SN, FC, OM
+#define BAS_ERR_FUNCTION (8)
+#define BAS_ERR_MEMORY 	(12)
+
+#define BAS_MAXLINE 	(255)														// Longest tokenised line.
+
+int  BASTokenise(const char *text,BYTE8 *tokens);
+int  BASLoad(const char *fileName);
+int  BASLoadNow(const char *fileName);
+int  BASSave(const char *fileName);
+int  BASDetokenise(const BYTE8 *memory,char *text,int size);
+int  BASListImage(const char *imageFile,const char *fileName);
+void BASListOnExit(const char *fileName);
+void BASEnd(void);
+
+#endif
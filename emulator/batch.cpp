@@ -0,0 +1,162 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		batch.cpp
+//		Purpose:	Run a BASIC program without a display : boot, load, RUN, print its output, exit
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sys_processor.h"
+#include "host.h"
+#include "console.h"
+#include "basic.h"
+#include "hypercall.h"
+#include "batch.h"
+
+// *******************************************************************************************************************************
+//
+//		The cold start questions are answered through the input vector. When BASIC is first ready the program is put
+//		in RAM and RUN is entered. Output is copied to stdout from when RUN has been read. After that the program's
+//		INPUT reads the -input stream, or stdin without one. It stops when BASIC gets back to OK (after the program
+//		ends, or an error), when a hypercall exits, when the cycle budget runs out, or when there is no more input.
+//
+// *******************************************************************************************************************************
+
+static const char *program = NULL;													// NULL if not in batch mode.
+static int until = BAT_UNTIL_OK;
+static long long budget = 0;														// Cycles, 0 is no limit.
+
+static const char *input;															// Text being entered.
+static int isEnteringRun = 0;														// It is RUN.
+static int isRunning = 0;															// RUN has been read.
+static int skipReturn = 0;															// Next CR is RUN's echo.
+static int isLineOpen = 0;															// Output doesn't end in a new line.
+static int exitCode = BAT_EXIT_OK;
+
+void BATSetProgram(const char *fileName) {
+	program = fileName;
+}
+
+void BATSetUntil(int condition) {
+	until = condition;
+}
+
+void BATSetBudget(long long cycles) {
+	budget = cycles;
+}
+
+int BATIsEnabled(void) {
+	return program != NULL;
+}
+
+// *******************************************************************************************************************************
+//											Input, output, and BASIC's progress
+// *******************************************************************************************************************************
+
+static int BATInputTrap(CPUSTATUS *registers) {
+	int ch;
+	if (*input != '\0') {
+		ch = *input++;
+		if (*input == '\0' && isEnteringRun) isRunning = skipReturn = 1;			// All of RUN read.
+	} else {
+		ch = CONReadInput();														// The program's own input.
+		if (ch == CON_WAIT) return CONWait(registers);
+		if (ch == CON_END) {														// Nothing left, it would wait
+			exitCode = BAT_EXIT_INPUT;												// for ever.
+			CPUExit();
+			return CPUTRAP_CONTINUE;
+		}
+	}
+	registers->a = ch;
+	registers->zero = (ch == 0);registers->sign = (ch & 0x80) != 0;
+	return CPUTRAP_RTS;
+}
+
+static int BATOutputTrap(CPUSTATUS *registers) {
+	if (!isRunning) return CPUTRAP_CONTINUE;
+	int ch = registers->a & 0x7F;
+	if (ch == 0x0D) {
+		if (!skipReturn) fputc('\n',stdout);
+		skipReturn = isLineOpen = 0;
+	} else if (ch >= ' ' && ch < 0x7F) {
+		fputc(ch,stdout);
+		skipReturn = 0;isLineOpen = 1;
+	}
+	return CPUTRAP_CONTINUE;
+}
+
+static int BATReadyTrap(CPUSTATUS *) {												// First time ready, load and RUN
+	CPUSetTrap(BAS_READY,NULL);
+	int result = BASLoadNow(program);
+	if (result <= 0) {
+		exitCode = BAT_EXIT_FAILED;
+		CPUExit();
+		return CPUTRAP_CONTINUE;
+	}
+	input = BAT_RUN;isEnteringRun = 1;
+	return CPUTRAP_CONTINUE;
+}
+
+static int BATOkTrap(CPUSTATUS *) {													// Back to OK
+	if (isRunning && until == BAT_UNTIL_OK) CPUExit();
+	return CPUTRAP_CONTINUE;
+}
+
+static int BATErrorTrap(CPUSTATUS *) {
+	if (isRunning) exitCode = BAT_EXIT_ERROR;
+	return CPUTRAP_CONTINUE;
+}
+
+// *******************************************************************************************************************************
+//		Run it, as fast as it will go. Returns the exit code. Cycles are added up a frame at a time as the processor's
+//		clock is only 32 bits.
+// *******************************************************************************************************************************
+
+static double BATTime(void) {
+	#ifdef LINUX
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC,&t);
+	return t.tv_sec + t.tv_nsec / 1.0e9;
+	#else
+	return (double)clock() / CLOCKS_PER_SEC;
+	#endif
+}
+
+int BATRun(void) {
+	input = BAT_COLDSTART;
+	if (!CONHasInput()) CONOpenInput("-");											// The program reads stdin.
+	CPUSetTrap(CON_INPUT,BATInputTrap);
+	CPUSetTrap(CON_OUTPUT,BATOutputTrap);
+	CPUSetTrap(BAS_READY,BATReadyTrap);
+	CPUSetTrap(BAT_OK,BATOkTrap);
+	CPUSetTrap(BAS_ERROR,BATErrorTrap);
+	if (until == BAT_UNTIL_HYPERCALL) HYPEnable();
+	long long cycles = 0;
+	LONG32 last = CPUGetClock();
+	double start = BATTime();
+	while (!CPUHasExited()) {
+		if (CPUExecuteInstruction() != 0) {											// End of frame
+			LONG32 now = CPUGetClock();
+			cycles += (LONG32)(now - last);last = now;
+			if (budget != 0 && cycles >= budget) {
+				exitCode = BAT_EXIT_BUDGET;
+				break;
+			}
+		}
+	}
+	cycles += (LONG32)(CPUGetClock() - last);
+	double seconds = BATTime() - start;
+	if (isLineOpen) fputc('\n',stdout);												// e.g. after "ERROR IN 20"
+	fflush(stdout);
+	HOSTEnd();
+	double emulated = (double)cycles / BAT_CPU_CLOCK;
+	fprintf(stderr,"%lld cycles (%.2fs emulated) in %.3fs, %.0fx real time, exit %d.\n",cycles,emulated,
+											seconds,(seconds > 0) ? emulated / seconds : 0.0,exitCode);
+	return exitCode;
+}
@@ -0,0 +1,35 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		batch.h
+//		Purpose:	Run a BASIC program without a display : boot, load, RUN, print its output, exit (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#define BAT_COLDSTART 	"C\r\r\r"													// D/C/W/M, MEMORY SIZE, TERMINAL WIDTH
+#define BAT_RUN 		"RUN\r"
+#define BAT_OK 			(0xA274)													// BASIC about to print OK
+#define BAT_CPU_CLOCK 	(1000000)													// Cycles per second, as sys_processor.cpp
+
+#define BAT_UNTIL_OK 		(0)														// Exit conditions
+#define BAT_UNTIL_HYPERCALL (1)
+
+#define BAT_EXIT_OK 		(0)														// Exit codes
+#define BAT_EXIT_FAILED 	(1)														// Couldn't load the program
+#define BAT_EXIT_ERROR 		(2)														// BASIC reported an error
+#define BAT_EXIT_BUDGET 	(3)														// Ran out of cycles
+#define BAT_EXIT_INPUT 		(4)														// Program wanted more input
+
+void BATSetProgram(const char *fileName);
+void BATSetUntil(int condition);
+void BATSetBudget(long long cycles);
+int  BATIsEnabled(void);
+int  BATRun(void);
+
+#endif
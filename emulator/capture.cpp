@@ -0,0 +1,145 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		capture.cpp
+//		Purpose:	Record the display to a raw RGB or Y4M video file
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <chrono>
+#include "sys_processor.h"
+#include "video.h"
+#include "handoff.h"
+#include "capture.h"
+
+// *******************************************************************************************************************************
+//
+//		Each frame the emulation copies video RAM into a bounded queue and carries on. A writer thread rasterises and
+//		writes them. If the queue is full the frame is dropped and the next one queued is written that many more times,
+//		so the file always has one frame per emulated frame (60 fps) however fast or slow the emulation runs.
+//
+// *******************************************************************************************************************************
+
+#define CAP_QUEUE 		(64)														// Frames waiting to be written.
+
+#define CAP_FOREGROUND 	(0xFF8800)													// Display colours, as RGB
+#define CAP_BACKGROUND 	(0x000000)
+
+typedef struct __CAPFRAME {
+	BYTE8 video[1024];																// Copy of $D000-$D3FF
+	int repeat;																		// Times to write it.
+} CAPFRAME;
+
+static SPSCQueue<CAPFRAME,CAP_QUEUE> queue;
+static CAPFRAME next;																// Frame being queued.
+static std::thread *writer = NULL;													// NULL if not capturing.
+static std::atomic<int> isClosing(0);
+static FILE *captureFile;
+static int isY4M;
+static int dropped = 0,pendingRepeat = 0;
+static LONG32 written = 0;
+
+static void CAPWriter(void);
+
+// *******************************************************************************************************************************
+//				Start capturing, Y4M if the file name ends .y4m, otherwise raw 24 bit RGB. "-" is stdout.
+// *******************************************************************************************************************************
+
+int CAPOpen(const char *fileName) {
+	captureFile = (strcmp(fileName,"-") == 0) ? stdout : fopen(fileName,"wb");
+	if (captureFile == NULL) { perror(fileName);return 0; }
+	setvbuf(captureFile,NULL,_IOFBF,1 << 20);
+	int n = strlen(fileName);
+	isY4M = (n > 4 && strcmp(fileName+n-4,".y4m") == 0);
+	if (isY4M) fprintf(captureFile,"YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C444\n",VID_WIDTH,VID_HEIGHT);
+	writer = new std::thread(CAPWriter);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//							End of frame on the emulation thread. Never waits for the writer.
+// *******************************************************************************************************************************
+
+void CAPFrame(void) {
+	if (writer == NULL) return;
+	for (int i = 0;i < 1024;i++) next.video[i] = CPUReadMemory(0xD000+i);
+	next.repeat = 1 + pendingRepeat;
+	if (queue.push(next)) {
+		pendingRepeat = 0;
+	} else {																		// Full, make it up next time.
+		pendingRepeat++;
+		dropped++;
+	}
+}
+
+// *******************************************************************************************************************************
+//									Finish writing what is queued and close the file
+// *******************************************************************************************************************************
+
+void CAPClose(void) {
+	if (writer == NULL) return;
+	if (pendingRepeat != 0) {														// Frames still to make up, write
+		next.repeat = pendingRepeat;												// the last one, waiting for room.
+		while (!queue.push(next)) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		pendingRepeat = 0;
+	}
+	isClosing = 1;
+	writer->join();
+	delete writer;
+	writer = NULL;
+	if (captureFile != stdout) fclose(captureFile); else fflush(stdout);
+	fprintf(stderr,"Captured %u frames, %d dropped and replaced by repeats.\n",written,dropped);
+}
+
+// *******************************************************************************************************************************
+//		The writer thread. Only two colours, so Y4M planes are made directly from the pixels rather than converted.
+// *******************************************************************************************************************************
+
+static void CAPYUV(LONG32 rgb,BYTE8 *yuv) {											// BT.601, studio range
+	int r = (rgb >> 16) & 0xFF,g = (rgb >> 8) & 0xFF,b = rgb & 0xFF;
+	yuv[0] = 16 + (65738 * r + 129057 * g + 25064 * b) / 256 / 1000;
+	yuv[1] = 128 + (-37945 * r - 74494 * g + 112439 * b) / 256 / 1000;
+	yuv[2] = 128 + (112439 * r - 94154 * g - 18285 * b) / 256 / 1000;
+}
+
+static void CAPWriter(void) {
+	static LONG32 pixels[VID_WIDTH*VID_HEIGHT];
+	static BYTE8 output[VID_WIDTH*VID_HEIGHT*3];
+	BYTE8 fgr[3],bgr[3];
+	if (isY4M) {
+		CAPYUV(CAP_FOREGROUND,fgr);CAPYUV(CAP_BACKGROUND,bgr);
+	} else {
+		for (int i = 0;i < 3;i++) {
+			fgr[i] = CAP_FOREGROUND >> (16-i*8);bgr[i] = CAP_BACKGROUND >> (16-i*8);
+		}
+	}
+	CAPFRAME frame;
+	while (1) {
+		if (!queue.pop(frame)) {
+			if (isClosing) break;													// Empty and finished.
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			continue;
+		}
+		VIDDrawScreen(frame.video,NULL,pixels,VID_WIDTH,1,1,0);						// 1 = foreground, 0 = background
+		int n = VID_WIDTH*VID_HEIGHT;
+		for (int i = 0;i < n;i++) {
+			const BYTE8 *c = pixels[i] ? fgr : bgr;
+			if (isY4M) {															// Planar
+				output[i] = c[0];output[i+n] = c[1];output[i+n*2] = c[2];
+			} else {																// Interleaved
+				output[i*3] = c[0];output[i*3+1] = c[1];output[i*3+2] = c[2];
+			}
+		}
+		for (int r = 0;r < frame.repeat;r++) {
+			if (isY4M) fputs("FRAME\n",captureFile);
+			fwrite(output,1,sizeof(output),captureFile);
+			written++;
+		}
+	}
+}
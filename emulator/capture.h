@@ -0,0 +1,19 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		capture.h
+//		Purpose:	Record the display to a raw RGB or Y4M video file (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _CAPTURE_H
+#define _CAPTURE_H
+
+int  CAPOpen(const char *fileName);
+void CAPFrame(void);
+void CAPClose(void);
+
+#endif
@@ -0,0 +1,126 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		console.cpp
+//		Purpose:	Guest character output and input connected to host streams
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#ifdef LINUX
+#include <poll.h>
+#endif
+#include "sys_processor.h"
+#include "console.h"
+
+static FILE *outputFile = NULL;														// Output copied here, NULL if not.
+static FILE *inputFile = NULL;														// Input read from here, NULL if not.
+
+// *******************************************************************************************************************************
+//		Everything the monitor and BASIC print goes through the $FFEE vector with the character in A. The trap copies it
+//		and lets the ROM carry on and display it. CR is a new line, LF and other control characters are dropped.
+// *******************************************************************************************************************************
+
+static int CONOutputTrap(CPUSTATUS *registers) {
+	int ch = registers->a & 0x7F;
+	if (ch == 0x0D) {
+		fputc('\n',outputFile);
+	} else if (ch >= ' ' && ch < 0x7F) {
+		fputc(ch,outputFile);
+	}
+	return CPUTRAP_CONTINUE;
+}
+
+int CONOpenOutput(const char *fileName) {
+	outputFile = (strcmp(fileName,"-") == 0) ? stdout : fopen(fileName,"w");
+	if (outputFile == NULL) { perror(fileName);return 0; }
+	CPUSetTrap(CON_OUTPUT,CONOutputTrap);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//		Input through the $FFEB vector returns the next byte of the stream at once, rather than it being typed on the
+//		keyboard. If the stream has nothing yet (e.g. a pipe) it stays at the vector, with time passing, and looks
+//		again, rather than the emulation thread waiting in a read. Letters are made capitals as with Shift Lock down,
+//		a new line is CR. At the end of the stream the trap is removed and the keyboard is used again.
+// *******************************************************************************************************************************
+
+static int CONIsWaiting(void) {														// Non-zero if a read would wait.
+	#ifdef LINUX
+	struct pollfd pending = { fileno(inputFile),POLLIN,0 };
+	return poll(&pending,1,0) <= 0 || (pending.revents & (POLLIN|POLLHUP)) == 0;
+	#else
+	return 0;
+	#endif
+}
+
+int CONReadInput(void) {															// Next byte, CON_WAIT or CON_END
+	if (inputFile == NULL) return CON_END;
+	int ch;
+	do {
+		if (CONIsWaiting()) return CON_WAIT;
+		ch = fgetc(inputFile);
+	} while (ch == '\r');
+	if (ch == EOF) {																// All read, close it.
+		if (inputFile != stdin) fclose(inputFile);
+		inputFile = NULL;
+		return CON_END;
+	}
+	if (ch == '\n') ch = 0x0D;
+	if (ch >= 'a' && ch <= 'z') ch = ch - 'a' + 'A';
+	return ch;
+}
+
+int CONWait(CPUSTATUS *registers) {													// Come back to the vector later.
+	registers->cycles += CON_POLL;
+	return CPUTRAP_JUMP;
+}
+
+static int CONInputTrap(CPUSTATUS *registers) {
+	int ch = CONReadInput();
+	if (ch == CON_WAIT) return CONWait(registers);
+	if (ch == CON_END) {															// All read, back to the keyboard
+		CPUSetTrap(CON_INPUT,NULL);
+		return CPUTRAP_CONTINUE;
+	}
+	registers->a = ch;
+	registers->zero = (ch == 0);registers->sign = (ch & 0x80) != 0;
+	return CPUTRAP_RTS;
+}
+
+int CONOpenInput(const char *fileName) {
+	inputFile = (strcmp(fileName,"-") == 0) ? stdin : fopen(fileName,"r");
+	if (inputFile == NULL) { perror(fileName);return 0; }
+	setvbuf(inputFile,NULL,_IONBF,0);												// So poll() sees all that's left.
+	CPUSetTrap(CON_INPUT,CONInputTrap);
+	return 1;
+}
+
+int CONHasInput(void) {
+	return inputFile != NULL;
+}
+
+int CONUsingStdin(void) {															// Stdin is ours, not the keyboard's.
+	return inputFile == stdin;
+}
+
+// *******************************************************************************************************************************
+//													Close the streams
+// *******************************************************************************************************************************
+
+void CONClose(void) {
+	if (inputFile != NULL) {
+		CPUSetTrap(CON_INPUT,NULL);
+		if (inputFile != stdin) fclose(inputFile);
+		inputFile = NULL;
+	}
+	if (outputFile != NULL) {
+		CPUSetTrap(CON_OUTPUT,NULL);
+		if (outputFile != stdout) fclose(outputFile); else fflush(stdout);
+		outputFile = NULL;
+	}
+}
@@ -0,0 +1,30 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		console.h
+//		Purpose:	Guest character output and input connected to host streams (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _CONSOLE_H
+#define _CONSOLE_H
+
+#define CON_INPUT 		(0xFFEB)													// Monitor input vector, JMP ($0218)
+#define CON_OUTPUT 		(0xFFEE)													// Monitor output vector, JMP ($021A)
+#define CON_POLL 		(1000)														// Cycles between looks for input
+
+#define CON_END 		(-1)														// CONReadInput() at the end of the stream
+#define CON_WAIT 		(-2)														// or with nothing yet.
+
+int  CONOpenOutput(const char *fileName);
+int  CONOpenInput(const char *fileName);
+int  CONReadInput(void);
+int  CONWait(CPUSTATUS *registers);
+int  CONHasInput(void);
+int  CONUsingStdin(void);
+void CONClose(void);
+
+#endif
@@ -11,9 +11,14 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <time.h>
+#ifdef LINUX
+#include <sys/resource.h>
+#endif
 #include "gfx.h"
 #include "sys_processor.h"
 #include "debugger.h"
+#include "handoff.h"
 	
 static int isInitialised = 0; 														// Flag to initialise first time
 static int addressSettings[] = { 0,0,0,0x20FFFF }; 									// Adjustable values : Code, Data, Other, Break.
@@ -21,7 +26,37 @@ static int keyMapping[16];															// Mapping for control keys to key valu
 static int inRunMode = 0;															// Non zero when free Running
 static int lastKey,currentKey;														// Last and Current key state
 static int stepBreakPoint;															// Extra breakpoint used for step over.
-static Uint32 nextFrame = 0;														// Time of next frame.
+static Uint32 nextPresent = 0;														// Time of next display update when running.
+
+#define DBG_IDLEWAIT 	(1000)																// Longest sleep when stopped (ms)
+
+static void DBGMeasure(int isRunning);
+
+// *******************************************************************************************************************************
+//
+//		When running, the emulation is on its own thread. It publishes a snapshot each frame through a triple buffer and
+//		receives keys and commands through a queue, so neither side ever waits on the other.
+//
+// *******************************************************************************************************************************
+
+#define DBGCMD_KEYUP	(0x100)														// Commands, or'ed with key for key events
+#define DBGCMD_KEYDOWN	(0x200)
+#define DBGCMD_RESET	(0x400)
+#define DBGCMD_BREAK	(0x800)
+
+static TripleBuffer<DEBUG_SNAPSHOT> frames;											// Frames from emulation thread.
+static DEBUG_SNAPSHOT pausedFrame;													// Display when stopped.
+static SPSCQueue<int,256> commands;													// Commands to emulation thread.
+static SDL_Thread *emulationThread = NULL;											// Emulation thread, NULL when stopped.
+static std::atomic<int> emulationStopped;											// Set when thread has stopped.
+static int runBreakPoint,runStepBreakPoint;											// Breakpoints for this run.
+static int frameDropped;															// Last published frame replaced unseen.
+
+static int DBGEmulationThread(void *);
+static void DBGStartEmulation(void);
+static void DBGStopEmulation(void);
+static int DBGProcessCommand(int command);
+static void DBGQueueCommand(int command);
 
 // *******************************************************************************************************************************
 //								Handle one frame of rendering etc. for the debugger.
@@ -46,10 +81,22 @@ void GFXXRender(SDL_Surface *surface,int autoStart) {
 		lastKey = currentKey = -1;
 	}
 
-	if (inRunMode != 0 || GFXIsKeyPressed(keyMapping[DBGKEY_SHOW]))					// Display system screen if Run or Sjhow
-		DEBUG_VDURENDER(addressSettings);
-	else 																			// Otherwise show Debugger screen
+	DBGMeasure(inRunMode != 0);														// Time since last frame, in this mode.
+
+	if (emulationThread != NULL && emulationStopped != 0) {							// Emulation hit a breakpoint.
+		DBGStopEmulation();
+		inRunMode = 0;
+		addressSettings[0] = DEBUG_HOMEPC();
+	}
+
+	if (inRunMode != 0) {															// Display latest frame if Run
+		DEBUG_VDURENDER(addressSettings,frames.read());
+	} else if (GFXIsKeyPressed(keyMapping[DBGKEY_SHOW])) {							// or current state if Show
+		DEBUG_TAKESNAPSHOT(&pausedFrame,0);
+		DEBUG_VDURENDER(addressSettings,&pausedFrame);
+	} else { 																		// Otherwise show Debugger screen
 		DEBUG_CPURENDER(addressSettings);
+	}
 
 	currentKey = -1;																// Identify which key is pressed.
 	for (int i = 0;i < 128;i++) {
@@ -68,8 +115,12 @@ void GFXXRender(SDL_Surface *surface,int autoStart) {
 			#define CMDKEY(n) GFXIsKeyPressed(keyMapping[n])						// Support Macro.
 
 			if (CMDKEY(DBGKEY_RESET)) {												// Reset processor (F1)
-				DEBUG_RESET();					
-				addressSettings[0] = DEBUG_HOMEPC();
+				if (emulationThread != NULL) {										// Running, so the emulation thread does it
+					DBGQueueCommand(DBGCMD_RESET);
+				} else {
+					DEBUG_RESET();					
+					addressSettings[0] = DEBUG_HOMEPC();
+				}
 				GFXSetFrequency(0);
 			}
 
@@ -109,6 +160,7 @@ void GFXXRender(SDL_Surface *surface,int autoStart) {
 				}
 			} else {																// In Run mode.
 				if (CMDKEY(DBGKEY_BREAK)) {
+					DBGStopEmulation();
 					inRunMode = 0;
 					addressSettings[0] = DEBUG_HOMEPC();
 				}
@@ -116,16 +168,152 @@ void GFXXRender(SDL_Surface *surface,int autoStart) {
 		} 
 	}
 	if (inRunMode != 0) {															// Running a program.
-		int frameRate = DEBUG_RUN(addressSettings[3],stepBreakPoint);				// Run a frame, or try to.
-		if (frameRate == 0) {														// Run code with step breakpoint, maybe.
-			inRunMode = 0;															// Break has occurred.
+		if (emulationThread == NULL) DBGStartEmulation();							// Start emulation thread if not running.
+		while (SDL_GetTicks() < nextPresent) SDL_Delay(1);							// Present at the display rate.
+		nextPresent = SDL_GetTicks() + 1000 / DEBUG_DISPLAYRATE;
+	} else {																		// Stopped, nothing changes until
+		GFXWaitForEvents(DBG_IDLEWAIT);												// there is some input.
+	}	
+}
+
+// *******************************************************************************************************************************
+//		Optionally measure the host CPU used (all threads) against elapsed time, separately while stopped and running.
+//		Reported every ten seconds and on exit, as a percentage of one core.
+// *******************************************************************************************************************************
+
+static int measureCPU = 0;
+static double measureLast[2],measureCPUTime[2][2];									// [stopped/running][cpu/elapsed]
+static Uint32 measureReport;
+
+static double DBGProcessTime(void) {												// CPU seconds used by the process.
+	#ifdef LINUX
+	struct rusage usage;
+	getrusage(RUSAGE_SELF,&usage);
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1.0e6;
+	#else
+	return (double)clock() / CLOCKS_PER_SEC;										// (Elapsed time on Windows)
+	#endif
+}
+
+void DBGMeasureCPU(void) {
+	measureCPU = 1;
+	measureLast[0] = DBGProcessTime();measureLast[1] = SDL_GetTicks() / 1000.0;
+	measureReport = SDL_GetTicks() + 10000;
+}
+
+static void DBGReportCPU(void) {
+	static const char *modes[] = { "stopped","running" };
+	for (int m = 0;m < 2;m++) {
+		if (measureCPUTime[m][1] > 0) {
+			printf("%s: %.1f%% CPU over %.1fs. ",modes[m],
+							measureCPUTime[m][0] * 100.0 / measureCPUTime[m][1],measureCPUTime[m][1]);
+		}
+	}
+	printf("\n");
+}
+
+static void DBGMeasure(int isRunning) {
+	if (measureCPU == 0) return;
+	double now[2] = { DBGProcessTime(), SDL_GetTicks() / 1000.0 };
+	for (int i = 0;i < 2;i++) {														// Add to the mode we were in.
+		measureCPUTime[isRunning][i] += now[i] - measureLast[i];
+		measureLast[i] = now[i];
+	}
+	if (SDL_GetTicks() >= measureReport) {
+		DBGReportCPU();
+		measureReport = SDL_GetTicks() + 10000;
+	}
+}
+
+// *******************************************************************************************************************************
+//								Start and stop the emulation thread. Only called by the UI thread.
+// *******************************************************************************************************************************
+
+static void DBGStartEmulation(void) {
+	runBreakPoint = addressSettings[3];												// Breakpoints can't change while running.
+	runStepBreakPoint = stepBreakPoint;
+	emulationStopped = 0;
+	DEBUG_TAKESNAPSHOT(frames.writeBuffer(),0);										// Something to show until the first frame.
+	frameDropped = frames.publish();
+	emulationThread = SDL_CreateThread(DBGEmulationThread,"emulation",NULL);
+}
+
+static void DBGStopEmulation(void) {
+	if (emulationThread != NULL) {
+		DBGQueueCommand(DBGCMD_BREAK);												// Ask it to stop, at most a frame.
+		SDL_WaitThread(emulationThread,NULL);
+		emulationThread = NULL;
+		int command;																// Anything it didn't get to, do now.
+		while (commands.pop(command)) DBGProcessCommand(command);
+	}
+}
+
+void DBGStop(void) {
+	DBGStopEmulation();
+	if (measureCPU) DBGReportCPU();
+}
+
+// *******************************************************************************************************************************
+//							Carry out a command from the UI, returns zero if it was a break
+// *******************************************************************************************************************************
+
+static int DBGProcessCommand(int command) {
+	if (command & DBGCMD_RESET) DEBUG_RESET();
+	if (command & (DBGCMD_KEYUP|DBGCMD_KEYDOWN)) 
+						DEBUG_KEYEVENT(command & 0xFF,(command & DBGCMD_KEYDOWN) != 0);
+	return (command & DBGCMD_BREAK) == 0;
+}
+
+// *******************************************************************************************************************************
+//		Queue a command for the emulation thread. Never dropped, as a lost key up or break would leave things stuck.
+// *******************************************************************************************************************************
+
+static void DBGQueueCommand(int command) {
+	while (!commands.push(command)) {												// Full, wait for the thread to catch up.
+		if (emulationStopped != 0) {												// It has stopped, so nothing will read
+			int queued;																// them ; the UI thread can do it now.
+			while (commands.pop(queued)) DBGProcessCommand(queued);
 		} else {
-			while (SDL_GetTicks() < nextFrame) {};									// Wait for frame timer to elapse.
-			nextFrame = SDL_GetTicks() + 1000 / frameRate;							// And calculate the next sync time.
+			SDL_Delay(1);
+		}
+	}
+}
 
+// *******************************************************************************************************************************
+//								The emulation thread. Runs frames until break or breakpoint.
+// *******************************************************************************************************************************
+
+static int DBGEmulationThread(void *) {
+	Uint32 nextFrame = SDL_GetTicks();
+	int isRunning = 1;
+	while (isRunning) {
+		int command;
+		while (isRunning && commands.pop(command)) {								// Process commands from the UI
+			isRunning = DBGProcessCommand(command);
 		}
-		addressSettings[0] = DEBUG_HOMEPC();
-	}	
+		if (isRunning == 0) break;
+		int frameRate = DEBUG_RUN(runBreakPoint,runStepBreakPoint);					// Run a frame, or try to.
+		DEBUG_TAKESNAPSHOT(frames.writeBuffer(),frameDropped);						// Publish it, keeping changes from
+		frameDropped = frames.publish();											// any frame the UI didn't see.
+		if (frameRate == 0) break;													// Break has occurred.
+		Uint32 now = SDL_GetTicks();												// Wait for frame timer to elapse.
+		if (now < nextFrame) SDL_Delay(nextFrame - now);
+		nextFrame = SDL_GetTicks() + 1000 / frameRate;								// And calculate the next sync time.
+	}
+	emulationStopped = 1;
+	return 0;
+}
+
+// *******************************************************************************************************************************
+//										Key state has changed, pass it to the hardware
+// *******************************************************************************************************************************
+
+void GFXXKeyEvent(int key,int isDown) {
+	if (emulationThread != NULL) {													// Running, queue it for the emulation thread
+		DBGQueueCommand(key | (isDown ? DBGCMD_KEYDOWN : DBGCMD_KEYUP));
+	} else {
+		DEBUG_KEYEVENT(key,isDown);
+	}
 }
 
 // *******************************************************************************************************************************
@@ -14,6 +14,8 @@
 
 void DBGVerticalLabel(int x,int y,const char *labels[],int fgr,int bgr);
 void DBGDefineKey(int keyID,int gfxKey);
+void DBGStop(void);
+void DBGMeasureCPU(void);
 
 #include "sys_debug_system.h"
 
@@ -16,10 +16,15 @@
 #include "gfx.h"
 #include <queue>
 #include <cmath>
+#include <atomic>
 
 
 static SDL_Window *mainWindow = NULL;
 static SDL_Surface *mainSurface = NULL;
+static SDL_Renderer *renderer = NULL;												// Used if presenting via a texture
+static SDL_Texture *texture = NULL;
+static int presentScale = 2;														// Window pixels per surface pixel (0 = none)
+static int presentVsync = 0;														// Non zero to wait for vertical sync.
 static int background;
 
 #define RED(x) ((((x) >> 8) & 0xF) * 17)
@@ -27,6 +32,7 @@ static int background;
 #define BLUE(x) ((((x) >> 0) & 0xF) * 17)
 
 static void _GFXInitialiseKeyRecord(void);
+static void _GFXPresent(int isFull);
 static void _GFXUpdateKeyRecord(int scancode,int isDown);
 
 static Beeper beeper;
@@ -44,44 +50,192 @@ void GFXOpenWindow(const char *title,int width,int height,int colour) {
 	}
 
 	mainWindow = SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, 					// Try to create a window
-							SDL_WINDOWPOS_UNDEFINED, width,height, SDL_WINDOW_SHOWN );
+							SDL_WINDOWPOS_UNDEFINED, width,height, 
+							SDL_WINDOW_SHOWN | (presentScale > 0 ? SDL_WINDOW_RESIZABLE : 0));
 	if (mainWindow == NULL) {
 		exit(printf( "Window could not be created! SDL_Error: %s\n", SDL_GetError() ));
 	}
 
-	mainSurface = SDL_GetWindowSurface(mainWindow);									// Get a surface to draw on.
+	if (presentScale > 0) {															// Draw at native size, scale to window
+		SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY,"nearest");
+		renderer = SDL_CreateRenderer(mainWindow,-1,
+							SDL_RENDERER_SOFTWARE | (presentVsync ? SDL_RENDERER_PRESENTVSYNC : 0));
+		if (renderer == NULL) {
+			exit(printf( "Renderer could not be created! SDL_Error: %s\n", SDL_GetError() ));
+		}
+		width = width / presentScale;height = height / presentScale;
+		SDL_RenderSetLogicalSize(renderer,width,height);							// Whole multiples of the native size
+		SDL_RenderSetIntegerScale(renderer,SDL_TRUE);
+		texture = SDL_CreateTexture(renderer,SDL_PIXELFORMAT_ARGB8888,SDL_TEXTUREACCESS_STREAMING,width,height);
+		mainSurface = SDL_CreateRGBSurfaceWithFormat(0,width,height,32,SDL_PIXELFORMAT_ARGB8888);
+	} else {
+		mainSurface = SDL_GetWindowSurface(mainWindow);								// Get a surface to draw on.
+	}
 
 	background = colour;															// Remember required backgrounds.
 	_GFXInitialiseKeyRecord();														// Set up key system.
 }
 
+// *******************************************************************************************************************************
+//
+//		Set how the surface is presented, before opening the window. Scale is the number of window pixels per drawn
+//		pixel, the window can be resized to other whole multiples. Scale 0 draws directly on the window surface.
+//
+// *******************************************************************************************************************************
+
+void GFXSetPresentation(int scale,int vsync) {
+	presentScale = (scale < 0) ? 0 : scale;
+	presentVsync = vsync;
+}
+
+int GFXWidth(void) { return mainSurface->w; }
+int GFXHeight(void) { return mainSurface->h; }
+
+// *******************************************************************************************************************************
+//
+//						Render to a 32 bit surface in memory with no window, e.g. for benchmarking
+//
+// *******************************************************************************************************************************
+
+void GFXOpenOffscreen(int width,int height) {
+	mainSurface = SDL_CreateRGBSurface(0,width,height,32,0xFF0000,0x00FF00,0x0000FF,0);
+	if (mainSurface == NULL) {
+		exit(printf( "Surface could not be created! SDL_Error: %s\n", SDL_GetError() ));
+	}
+}
+
 // *******************************************************************************************************************************
 //
 //												Start the main rendering loop
 //
 // *******************************************************************************************************************************
 
-static int isRunning = -1;																// Is app running
+static std::atomic<int> isRunning(-1);													// Is app running (cleared from any thread)
+
+#define MAXDAMAGE 	(256)															// Max areas updated in a retained frame.
+
+static int fullRedraw = 1;															// Non zero if redrawing everything.
+static int retainFrame = 0;															// Set by app to keep the frame.
+static SDL_Rect damage[MAXDAMAGE];													// Changed areas of a retained frame.
+static int damageCount = 0;
+static int idleWait = 0;															// If non zero, wait this long for events.
+
+static void _GFXHandleEvent(SDL_Event *event) {
+	if (event->type == SDL_KEYDOWN && event->key.keysym.sym == SDLK_ESCAPE) 		// Exit if ESC pressed.
+																		isRunning = 0;
+	if (event->type == SDL_KEYDOWN || event->type == SDL_KEYUP)						// Handle other keys.
+				_GFXUpdateKeyRecord(event->key.keysym.sym,event->type == SDL_KEYDOWN);
+	if (event->type == SDL_WINDOWEVENT) fullRedraw = 1;								// Exposed etc., draw it all.
+}
 
 void GFXStart(int autoStart) {
 
 	SDL_Event event;
 
 	while(isRunning) {																// While still running.
+		if (idleWait > 0 && !fullRedraw) {											// Nothing happening, sleep till an event
+			if (SDL_WaitEventTimeout(&event,idleWait)) _GFXHandleEvent(&event);		// or the timeout.
+		}
+		idleWait = 0;
 		while (SDL_PollEvent(&event)) {												// While events in event queue.
-			if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) 	// Exit if ESC pressed.
-																			isRunning = 0;
-			if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP)				// Handle other keys.
-						_GFXUpdateKeyRecord(event.key.keysym.sym,event.type == SDL_KEYDOWN);
+			_GFXHandleEvent(&event);
 		}
-		SDL_FillRect(mainSurface, NULL, 											// Draw the background.
+		if (fullRedraw) {
+			SDL_FillRect(mainSurface, NULL, 										// Draw the background.
 							SDL_MapRGB(mainSurface->format, RED(background),GREEN(background),BLUE(background)));
+		}
+		retainFrame = 0;damageCount = 0;
 		GFXXRender(mainSurface,autoStart);											// Ask app to render state.
-		SDL_UpdateWindowSurface(mainWindow);										// And update the main window.
+		_GFXPresent(fullRedraw || damageCount > MAXDAMAGE);							// And update the main window.
+		fullRedraw = (retainFrame == 0);
 	}
 	SDL_CloseAudio();
 }
 
+// *******************************************************************************************************************************
+//
+//		Show the surface, all of it or the damaged areas. Via a texture, copy the changed areas into it, then it is
+//		scaled to the window in one go. Otherwise it is the window's own surface.
+//
+// *******************************************************************************************************************************
+
+static void _GFXPresent(int isFull) {
+	if (renderer == NULL) {
+		if (isFull) {
+			SDL_UpdateWindowSurface(mainWindow);	
+		} else if (damageCount > 0) {												// Or just the parts that changed.
+			SDL_UpdateWindowSurfaceRects(mainWindow,damage,damageCount);
+		}
+		return;
+	}
+	if (isFull) {
+		SDL_UpdateTexture(texture,NULL,mainSurface->pixels,mainSurface->pitch);
+	} else {
+		if (damageCount == 0) return;												// Nothing changed, nothing to do.
+		for (int i = 0;i < damageCount;i++) {
+			Uint8 *pixels = (Uint8 *)mainSurface->pixels + damage[i].y * mainSurface->pitch + damage[i].x * 4;
+			SDL_UpdateTexture(texture,&damage[i],pixels,mainSurface->pitch);
+		}
+	}
+	SDL_RenderClear(renderer);
+	SDL_RenderCopy(renderer,texture,NULL,NULL);
+	SDL_RenderPresent(renderer);
+}
+
+// *******************************************************************************************************************************
+//
+//		Direct access to the pixels, if they are 32 bit, otherwise returns NULL. Pitch is in pixels.
+//
+// *******************************************************************************************************************************
+
+Uint32 *GFXLockPixels(int *pitch) {
+	if (mainSurface->format->BytesPerPixel != 4) return NULL;
+	if (SDL_MUSTLOCK(mainSurface)) SDL_LockSurface(mainSurface);
+	*pitch = mainSurface->pitch / 4;
+	return (Uint32 *)mainSurface->pixels;
+}
+
+void GFXUnlockPixels(void) {
+	if (SDL_MUSTLOCK(mainSurface)) SDL_UnlockSurface(mainSurface);
+}
+
+Uint32 GFXColour(int colour) {
+	return SDL_MapRGB(mainSurface->format,RED(colour),GREEN(colour),BLUE(colour));
+}
+
+// *******************************************************************************************************************************
+//
+//		Retained frames. Normally the window is cleared and redrawn each frame. If the app calls GFXRetainFrame() the
+//		surface is kept for the next frame, which only redraws and reports (GFXDamage) what has changed. If nothing
+//		can change without input, GFXWaitForEvents() sleeps before the next frame until there is some (or timeout ms)
+//
+// *******************************************************************************************************************************
+
+void GFXRetainFrame(void) {
+	retainFrame = 1;
+}
+
+int GFXIsFullRedraw(void) {
+	return fullRedraw;
+}
+
+void GFXRedrawAll(void) {															// Start again on a retained frame.
+	if (!fullRedraw) {
+		SDL_FillRect(mainSurface, NULL, 
+							SDL_MapRGB(mainSurface->format, RED(background),GREEN(background),BLUE(background)));
+		fullRedraw = 1;
+	}
+}
+
+void GFXWaitForEvents(int timeout) {												// Before the next frame, wait for input
+	idleWait = timeout;
+}
+
+void GFXDamage(SDL_Rect *rc) {
+	if (damageCount < MAXDAMAGE) damage[damageCount] = *rc;
+	damageCount++;																	// Too many, just update the lot.
+}
+
 // *******************************************************************************************************************************
 //
 //											Exit Program
@@ -108,6 +262,11 @@ void GFXCloseOnDebug(void) {
 // *******************************************************************************************************************************
 
 void GFXCloseWindow(void) {
+	if (renderer != NULL) {															// Texture, renderer and surface
+		SDL_DestroyTexture(texture);
+		SDL_DestroyRenderer(renderer);
+		SDL_FreeSurface(mainSurface);
+	}
 	SDL_DestroyWindow(mainWindow);													// Destroy working window
 	SDL_Quit();																		// Exit SDL.
 }
@@ -122,6 +281,25 @@ void GFXRectangle(SDL_Rect *rc,int colour) {
 	SDL_FillRect(mainSurface,rc,SDL_MapRGB(mainSurface->format,RED(colour),GREEN(colour),BLUE(colour)));
 }
 
+// *******************************************************************************************************************************
+//
+//						Off screen surfaces, in the same format as the display so blits are just copies
+//
+// *******************************************************************************************************************************
+
+SDL_Surface *GFXCreateSurface(int width,int height) {
+	SDL_PixelFormat *f = mainSurface->format;
+	return SDL_CreateRGBSurface(0,width,height,f->BitsPerPixel,f->Rmask,f->Gmask,f->Bmask,f->Amask);
+}
+
+void GFXSurfaceRectangle(SDL_Surface *surface,SDL_Rect *rc,int colour) {
+	SDL_FillRect(surface,rc,SDL_MapRGB(surface->format,RED(colour),GREEN(colour),BLUE(colour)));
+}
+
+void GFXBlit(SDL_Surface *surface,SDL_Rect *from,SDL_Rect *to) {
+	SDL_BlitSurface(surface,from,mainSurface,to);
+}
+
 // *******************************************************************************************************************************
 //
 //									Support Routine - Draw 5 x 7 bitmap font character
@@ -130,9 +308,52 @@ void GFXRectangle(SDL_Rect *rc,int colour) {
 
 #include "font.h"
 
-void GFXCharacter(int xc,int yc,int character,int size,int colour,int back) {
+#define FONTCACHE 	(8)																// Number of size/colour fonts kept.
+
+static struct _FontCache {
+	SDL_Surface *glyphs;															// Characters $20-$7F in a strip, NULL if unused
+	int size,colour;
+} fontCache[FONTCACHE];
+static int fontReplace = 0;															// Next entry to reuse when full.
+
+static SDL_Surface *_GFXGetFont(int size,int colour) {
+	for (int i = 0;i < FONTCACHE;i++) {												// Already drawn ?
+		if (fontCache[i].glyphs != NULL && fontCache[i].size == size && fontCache[i].colour == colour) {
+			return fontCache[i].glyphs;
+		}
+	}
+	struct _FontCache *f = &fontCache[fontReplace];									// Replace oldest.
+	fontReplace = (fontReplace + 1) % FONTCACHE;
+	if (f->glyphs != NULL) SDL_FreeSurface(f->glyphs);
+	f->size = size;f->colour = colour;
+	f->glyphs = GFXCreateSurface(96 * 6 * size,8 * size);
+	int key = (colour == 0) ? 0xFFF : 0x000;										// Transparent, anything but colour.
+	GFXSurfaceRectangle(f->glyphs,NULL,key);
+	SDL_SetColorKey(f->glyphs,SDL_TRUE,SDL_MapRGB(f->glyphs->format,RED(key),GREEN(key),BLUE(key)));
+	SDL_Rect rc;
+	rc.w = rc.h = size;																// Width and Height of pixel.
+	for (int c = 0;c < 96;c++) {
+		for (int x = 0;x < 5;x++) {													// 5 Across
+			rc.x = (c * 6 + x) * size;
+			for (int y = 0;y < 7;y++) {												// 7 Down
+				rc.y = y * size;
+				if (fontdata[c*5+x] & (0x01 << y)) {								// Is bit set ? (note inversion)
+					GFXSurfaceRectangle(f->glyphs,&rc,colour);						// If so, draw the pixel
+				}
+			}
+		}
+	}
+	return f->glyphs;
+}
+
+static void _GFXFlushFonts(void) {
+	for (int i = 0;i < FONTCACHE;i++) {
+		if (fontCache[i].glyphs != NULL) SDL_FreeSurface(fontCache[i].glyphs);
+		fontCache[i].glyphs = NULL;
+	}
+}
 
-	Uint32 col = SDL_MapRGB(mainSurface->format,RED(colour),GREEN(colour),BLUE(colour));				
+void GFXCharacter(int xc,int yc,int character,int size,int colour,int back) {
 	SDL_Rect rc;
 	if (back >= 0) {
 		Uint32 col2 = SDL_MapRGB(mainSurface->format,RED(back),GREEN(back),BLUE(back));				
@@ -141,16 +362,10 @@ void GFXCharacter(int xc,int yc,int character,int size,int colour,int back) {
 	}
 	if (character < 32 || character >= 128) character = '?';						// Unknown character
 	character = character - 32;														// First font item is $20 (Space)
-	rc.w = rc.h = size;																// Width and Height of pixel.
-	for (int x = 0;x < 5;x++) {														// 5 Across
-		rc.x = xc + x * size;
-		for (int y = 0;y < 7;y++) {													// 7 Down
-			rc.y = yc + y * size;
-			if (fontdata[character*5+x] & (0x01 << y)) {							// Is bit set ? (note inversion)
-				SDL_FillRect(mainSurface,&rc,col);									// If so, draw the pixel
-			}
-		}
-	}
+	SDL_Rect from;
+	from.x = character * 6 * size;from.y = 0;from.w = 6 * size;from.h = 8 * size;
+	rc.x = xc;rc.y = yc;rc.w = from.w;rc.h = from.h;
+	SDL_BlitSurface(_GFXGetFont(size,colour),&from,mainSurface,&rc);				// Copy from the cached font.
 }
 
 // *******************************************************************************************************************************
@@ -167,6 +382,7 @@ void GFXDefineCharacter(int nChar,int b1,int b2,int b3,int b4,int b5) {
 		fontdata[nChar++] = b3;
 		fontdata[nChar++] = b4;
 		fontdata[nChar++] = b5;
+		_GFXFlushFonts();															// Cached fonts now out of date.
 	}
 }
 
@@ -191,10 +407,14 @@ void GFXString(int xc,int yc,const char *text,int size,int colour,int back) {
 // *******************************************************************************************************************************
 
 void GFXNumber(int xc,int yc,int number,int base,int width,int size,int colour,int back) {
-	if (width > 0) {
-		GFXNumber(xc,yc,number/base,base,width-1,size,colour,back);
-		GFXCharacter(xc + size*6*(width-1),yc,"0123456789ABCDEF"[number % base],size,colour,back);
+	char buffer[33];
+	if (width > 32) width = 32;
+	buffer[width] = '\0';
+	for (int i = width-1;i >= 0;i--) {												// Digits, least significant last.
+		buffer[i] = "0123456789ABCDEF"[number % base];
+		number = number / base;
 	}
+	GFXString(xc,yc,buffer,size,colour,back);
 }
 
 // *******************************************************************************************************************************
@@ -258,24 +478,36 @@ struct _KeyRecord {
 
 static struct _KeyRecord keyState[128];												// Array of key state records.
 
+#define SDLKEY_INDEX(k)	(((k) & SDLK_SCANCODE_MASK) ? 128+((k) & 0x1FF) : ((k) < 128 ? (k) : SDLKEY_COUNT))
+#define SDLKEY_COUNT 	(128+512)														// ASCII keys, then SDL scancodes.
+
+static unsigned char sdlKeyToGfx[SDLKEY_COUNT];										// Reverse lookup, SDL key index to GFX key (0 = none)
+
 static void _GFXInitialiseKeyRecord(void) {
 	for (int i = 0;i < 128;i++) {													// Erase the whole structure.
 		keyState[i].sdlKey = keyState[i].gfxKey = keyState[i].isPressed = 0;
 	}
+	for (int i = 0;i < SDLKEY_COUNT;i++) sdlKeyToGfx[i] = 0;						// And the reverse lookup.
 	int n = 0;
 	while (keyTable[n] != -1) {														// Scan the list of known keys.
 		keyState[keyTable[n]].gfxKey = keyTable[n];									// Save gfx number of the key.
 		keyState[keyTable[n]].sdlKey = keyTable[n+1];								// Save the corresponding SDL key.
+		if (keyTable[n+1] >= 0) sdlKeyToGfx[SDLKEY_INDEX(keyTable[n+1])] = keyTable[n];
 		n = n + 2;
 	}
 }
 
 static void _GFXUpdateKeyRecord(int scancode,int isDown) {
-	for (int i = 0;i < 128;i++)														// Find key with corresponding scan code
-		if (keyState[i].sdlKey == scancode)
-			keyState[i].isPressed = (isDown != 0);									// Copy state into it.
+	int index = SDLKEY_INDEX(scancode);												// Find key with corresponding scan code
+	if (scancode < 0 || index >= SDLKEY_COUNT) return;								// (Unicode keys on other layouts)
+	int gfxKey = sdlKeyToGfx[index];
+	if (gfxKey == 0) return;														// Not a key we know about.
+	isDown = (isDown != 0);
+	if (keyState[gfxKey].isPressed == isDown) return;								// Auto repeat, nothing changed.
+	keyState[gfxKey].isPressed = isDown;											// Copy state into it.
 	keyState[GFXKEY_SHIFT].isPressed = 												// Either shift key operates SHIFT.
 					keyState[GFXKEY_LSHIFT].isPressed || keyState[GFXKEY_RSHIFT].isPressed;
+	GFXXKeyEvent(gfxKey,isDown);													// Tell the application.
 }
 
 // *******************************************************************************************************************************
@@ -0,0 +1,84 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		handoff.h
+//		Purpose:	Lock free single producer / single consumer handoff between threads
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _HANDOFF_H
+#define _HANDOFF_H
+
+#include <atomic>
+
+// *******************************************************************************************************************************
+//
+//		Triple buffer. The writer fills writeBuffer() and calls publish(), the reader calls read() to get the most recently
+//		published buffer. Neither side ever waits ; frames the reader is too slow to see are simply replaced.
+//
+// *******************************************************************************************************************************
+
+#define TRIPLE_NEW 	(4)																// Set in middle if not yet read.
+
+template <class T> class TripleBuffer
+{
+private:
+	T buffers[3];
+	std::atomic<int> middle;														// Buffer being handed over.
+	int back,front;																	// Owned by writer and reader.
+public:
+	TripleBuffer() : middle(1),back(0),front(2) {}
+
+	T *writeBuffer(void) {
+		return &buffers[back];
+	}
+	int publish(void) {																// Returns non zero if a frame was dropped
+		int previous = middle.exchange(back | TRIPLE_NEW,std::memory_order_acq_rel);
+		back = previous & 3;
+		return (previous & TRIPLE_NEW) != 0;
+	}
+	T *read(void) {
+		if (middle.load(std::memory_order_acquire) & TRIPLE_NEW) {
+			front = middle.exchange(front,std::memory_order_acq_rel) & 3;
+		}
+		return &buffers[front];
+	}
+};
+
+// *******************************************************************************************************************************
+//
+//							Bounded queue, one thread pushes and one thread pops. N must be a power of 2.
+//
+// *******************************************************************************************************************************
+
+template <class T,int N> class SPSCQueue
+{
+private:
+	T items[N];
+	std::atomic<unsigned> head,tail;
+public:
+	SPSCQueue() : head(0),tail(0) {}
+
+	int push(const T &item) {														// Returns zero if full.
+		unsigned t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) == (unsigned)N) return 0;
+		items[t & (N-1)] = item;
+		tail.store(t+1,std::memory_order_release);
+		return 1;
+	}
+	int pop(T &item) {																// Returns zero if empty.
+		unsigned h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return 0;
+		item = items[h & (N-1)];
+		head.store(h+1,std::memory_order_release);
+		return 1;
+	}
+	int count(void) {
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+};
+
+#endif
@@ -14,13 +14,18 @@
 #include "sys_processor.h"
 #include "sys_debug_system.h"
 #include "debugger.h"
+#include "host.h"
+#include "batch.h"
 
 int main(int argc,char *argv[]) {
 	DEBUG_RESET();
-	DEBUG_ARGUMENTS(argc,argv);
+	int autoStart = DEBUG_ARGUMENTS(argc,argv);
+	if (BATIsEnabled()) return BATRun();											// No window, as fast as possible.
 	GFXOpenWindow(WIN_TITLE,WIN_WIDTH,WIN_HEIGHT,WIN_BACKCOLOUR);
-	GFXStart(argc == 3);
+	GFXStart(autoStart);
+	DBGStop();
 	CPUEndRun();
+	HOSTEnd();
 	GFXCloseWindow();
 	return(0);
 }
@@ -12,16 +12,25 @@
 #include "sys_processor.h"
 #include "hardware.h"
 
+static BYTE8 keyMatrix[8];															// Keyboard matrix image, one byte per row.
+static void HWSetMatrixKey(int position,int isDown);
+
 #if defined(WINDOWS) || defined(LINUX)
 
-#include "gfx.h"
+#include "gfxkeys.h"
+#include "host.h"
 #include <stdlib.h>
 
 // *******************************************************************************************************************************
 //												Reset Hardware
 // *******************************************************************************************************************************
 
+static BYTE8 keyPosition[128];														// Key code => matrix position + 1 (0 = none)
+static void HWInitialiseKeyPositions(void);
+
 void HWReset(void) {
+	HWInitialiseKeyPositions();
+	keyMatrix[7] |= 0x01;															// Shift Lock is always down.
 }
 
 // *******************************************************************************************************************************
@@ -29,13 +38,42 @@ void HWReset(void) {
 // *******************************************************************************************************************************
 
 void HWSync(void) {
+	HOSTSync();																		// Frame end services on the host.
 }
 
 // *******************************************************************************************************************************
-//									  Write to display/colour RAM
+//						Write to display/colour RAM. Only called if it changed, record which bytes
 // *******************************************************************************************************************************
 
-void HWWriteDisplay(WORD16 address,BYTE8 data) {	
+static BYTE8 displayChanges[1024/8];												// Bit set for each changed byte of $D000-$D3FF
+
+void HWWriteDisplay(WORD16 address,BYTE8) {	
+	if (address >= 0xD000 && address < 0xD400) {
+		address -= 0xD000;
+		displayChanges[address >> 3] |= (1 << (address & 7));
+	}
+}
+
+// *******************************************************************************************************************************
+//										A block of the display has been changed in one go
+// *******************************************************************************************************************************
+
+void HWWriteDisplayRange(WORD16 address,int count) {
+	for (int i = 0;i < count;i++) {
+		int offset = address + i - 0xD000;
+		if (offset >= 0 && offset < 1024) displayChanges[offset >> 3] |= (1 << (offset & 7));
+	}
+}
+
+// *******************************************************************************************************************************
+//				Copy out the display changes since last called and clear them. Merge adds to the ones already there.
+// *******************************************************************************************************************************
+
+void HWGetDisplayChanges(BYTE8 *changes,int merge) {
+	for (int i = 0;i < 1024/8;i++) {
+		changes[i] = merge ? (changes[i] | displayChanges[i]) : displayChanges[i];
+		displayChanges[i] = 0;
+	}
 }
 
 // *******************************************************************************************************************************
@@ -53,23 +91,107 @@ static const BYTE8 keyboardMap[] = {
 	0,GFXKEY_CONTROL,0,0,0,GFXKEY_LSHIFT,GFXKEY_RSHIFT,0	
 };
 
-BYTE8 HWWriteKeyboard(BYTE8 pattern) {
-	pattern = pattern ^ 0xFF;
-	BYTE8 outPattern = 0x00;
-	for (BYTE8 row = 0;row < 8;row++) {
-		if ((pattern & (0x80 >> row)) != 0) {
-			for (BYTE8 col = 0;col < 8;col++) {
-				if (GFXIsKeyPressed(keyboardMap[row*8+col])) {
-					outPattern = outPattern | (0x80 >> col);
-				}
+static void HWInitialiseKeyPositions(void) {
+	for (int i = 0;i < 128;i++) keyPosition[i] = 0;
+	for (int i = 0;i < 64;i++) {
+		if (keyboardMap[i] != 0) keyPosition[keyboardMap[i]] = i+1;
+	}
+}
+
+// *******************************************************************************************************************************
+//		Keys to hold down to type an ASCII character, returns how many (0 if it can't be typed). Shift Lock is always
+//		down so letters are capitals. Shift gives ASCII ^ $10 on the number and punctuation keys, the '@' key is ':'
+// *******************************************************************************************************************************
+
+static const char shiftedKeys[] = "!1\"2#3$4%5&6'7(8)9@0*@=->.<,?/+;";			// Character, key pressed with shift.
+
+int HWASCIIKeys(int ch,int *keys) {
+	int n = 0;
+	if (ch == 13 || ch == 10) { keys[0] = GFXKEY_RETURN;return 1; }
+	if (ch == 8 || ch == 127) { keys[0] = GFXKEY_BACKSPACE;return 1; }
+	if (ch >= 'a' && ch <= 'z') ch = ch - 'a' + 'A';								// Make lower case upper case
+	if (ch > 0 && ch < 27) { keys[n++] = GFXKEY_CONTROL;ch = ch + '@'; }			// Control keys.
+	for (int i = 0;shiftedKeys[i] != '\0';i += 2) {								// Shifted punctuation.
+		if (ch == shiftedKeys[i]) { keys[n++] = GFXKEY_LSHIFT;ch = shiftedKeys[i+1];break; }
+	}
+	if (ch == ':') ch = '@';
+	if (ch <= 0 || ch >= 128 || keyPosition[ch] == 0) return 0;
+	keys[n++] = ch;
+	return n;
+}
+
+// *******************************************************************************************************************************
+//								  Key pressed or released on the host, update the matrix
+// *******************************************************************************************************************************
+
+void HWKeyboardEvent(int key,int isDown) {
+	if (key >= 'a' && key <= 'z') key = key - 'a' + 'A';							// Make lower case upper case
+	if (key > 0 && key < 128 && keyPosition[key] != 0) {
+		HWSetMatrixKey(keyPosition[key]-1,isDown);
+	}
+}
+
+// *******************************************************************************************************************************
+//
+//		Auto type. Text is typed by holding its keys down until the guest has read the key's row HW_TYPEHOLD times, then
+//		released until it has read every row with nothing down, which is what a debouncing scan needs to see a new
+//		(perhaps the same) key. As it is driven by the guest's reads of $DF00 rather than frames, it types as fast as
+//		whatever is scanning can take it.
+//
+// *******************************************************************************************************************************
+
+#define HW_TYPEQUEUE 	(65536)														// Characters waiting.
+#define HW_TYPEHOLD 	(4)															// Reads of the row while down (CEGMON needs 3)
+
+#define TYPE_IDLE 		(0)
+#define TYPE_DOWN 		(1)
+#define TYPE_UP 		(2)
+
+static BYTE8 typeQueue[HW_TYPEQUEUE];
+static int typeHead = 0,typeTail = 0;
+static int typeState = TYPE_IDLE;
+static int typeKeys[3],typeKeyCount;												// Keys held for this character.
+static BYTE8 typeRow;																// Row bit of the main key.
+static int typeReads;																// Reads of that row while down.
+static BYTE8 typeRowsSeen;															// Rows read while all up.
+
+int HWTypeText(const char *text) {
+	int n = 0;
+	while (text[n] != '\0' && (typeTail + 1) % HW_TYPEQUEUE != typeHead) {
+		typeQueue[typeTail] = text[n++];
+		typeTail = (typeTail + 1) % HW_TYPEQUEUE;
+	}
+	return n;																		// Number of characters queued.
+}
+
+int HWIsTyping(void) {
+	return typeState != TYPE_IDLE || typeHead != typeTail;
+}
+
+static void HWAutoType(BYTE8 selected) {
+	if (typeState == TYPE_IDLE) {													// Start the next character.
+		while (typeHead != typeTail && typeState == TYPE_IDLE) {
+			typeKeyCount = HWASCIIKeys(typeQueue[typeHead],typeKeys);
+			typeHead = (typeHead + 1) % HW_TYPEQUEUE;
+			if (typeKeyCount > 0) {
+				for (int i = 0;i < typeKeyCount;i++) HWKeyboardEvent(typeKeys[i],1);
+				typeRow = 0x80 >> ((keyPosition[typeKeys[typeKeyCount-1]]-1) >> 3);
+				typeReads = 0;
+				typeState = TYPE_DOWN;
 			}
 		}
 	}
-	if (pattern & 0x01) {
-		outPattern |= 1;
+	if (typeState == TYPE_DOWN && (selected & typeRow) != 0) {						// Seen enough, release it.
+		if (++typeReads > HW_TYPEHOLD) {
+			for (int i = typeKeyCount-1;i >= 0;i--) HWKeyboardEvent(typeKeys[i],0);
+			typeState = TYPE_UP;
+			typeRowsSeen = 0;
+		}
+	}
+	if (typeState == TYPE_UP) {														// Wait till all rows seen empty.
+		typeRowsSeen |= selected;
+		if (typeRowsSeen == 0xFF) typeState = TYPE_IDLE;
 	}
-	outPattern = outPattern ^ 0xFF;
-	return outPattern;
 }
 
 #endif
@@ -83,7 +205,11 @@ BYTE8 HWWriteKeyboard(BYTE8 pattern) {
 //												Reset Hardware
 // *******************************************************************************************************************************
 
+static BYTE8 keyPosition[256];														// Scan code => matrix position + 1 (0 = none)
+static void HWInitialiseKeyPositions(void);
+
 void HWReset(void) {
+	HWInitialiseKeyPositions();
 }
 
 // *******************************************************************************************************************************
@@ -109,6 +235,7 @@ void HWSync(void) {
 			scanCode = (scanCode & 0x7F) | shift;
 			//writeCharacter(scanCode & 0x0F,(scanCode >> 4)+2,isDown ? '*' : '.');
 			keyStatus[scanCode] = isDown;
+			if (keyPosition[scanCode] != 0) HWSetMatrixKey(keyPosition[scanCode]-1,isDown);
 			shift = 0x00;
 			release = 0x00;
 		}
@@ -130,6 +257,10 @@ void HWWriteDisplay(WORD16 address,BYTE8 data) {
 	}
 }
 
+void HWWriteDisplayRange(WORD16 address,int count) {
+	for (int i = 0;i < count;i++) HWWriteDisplay(address+i,CPUReadMemory(address+i));
+}
+
 // *******************************************************************************************************************************
 //											Access keyboard
 // *******************************************************************************************************************************
@@ -145,21 +276,42 @@ static const BYTE8 keyboardMap[] = {
 		0x00,0x14,0x76,0x00,0x00,0x12,0x59,0x00		// . CTL ESC . . LShift RShift .
 };
 
+static void HWInitialiseKeyPositions(void) {
+	for (int i = 0;i < 256;i++) keyPosition[i] = 0;
+	for (int i = 0;i < 64;i++) {
+		if (keyboardMap[i] != 0) keyPosition[keyboardMap[i]] = i+1;
+	}
+}
+
+#endif
+
+// *******************************************************************************************************************************
+//						Set or clear a key in the matrix image. Position is row * 8 + column
+// *******************************************************************************************************************************
+
+static void HWSetMatrixKey(int position,int isDown) {
+	BYTE8 bit = 0x80 >> (position & 7);
+	if (isDown) {
+		keyMatrix[position >> 3] |= bit;
+	} else {
+		keyMatrix[position >> 3] &= (bit ^ 0xFF);
+	}
+}
+
+// *******************************************************************************************************************************
+//						Write to $DF00 selects rows (active low), read back the columns (active low)
+// *******************************************************************************************************************************
+
 BYTE8 HWWriteKeyboard(BYTE8 pattern) {
 	pattern = pattern ^ 0xFF;
+	#if defined(WINDOWS) || defined(LINUX)
+	if (typeState != TYPE_IDLE || typeHead != typeTail) HWAutoType(pattern);		// Auto typing.
+	#endif
 	BYTE8 outPattern = 0x00;
 	for (BYTE8 row = 0;row < 8;row++) {
-		if ((pattern & (0x80 >> row)) != 0) {
-			for (BYTE8 col = 0;col < 8;col++) {
-				if (keyStatus[keyboardMap[row*8+col]] != 0) {
-					outPattern = outPattern | (0x80 >> col);
-				}
-			}
-		}
+		if ((pattern & (0x80 >> row)) != 0) outPattern |= keyMatrix[row];
 	}
 	outPattern = outPattern ^ 0xFF;
 	return outPattern;
 }
 
-#endif
-
@@ -15,7 +15,13 @@
 void HWReset(void);
 void HWSync(void);
 BYTE8 HWWriteKeyboard(BYTE8 pattern);
+void HWKeyboardEvent(int key,int isDown);
+int HWASCIIKeys(int ch,int *keys);
+int HWTypeText(const char *text);
+int HWIsTyping(void);
 void HWWriteDisplay(WORD16 address,BYTE8 data);
+void HWWriteDisplayRange(WORD16 address,int count);
+void HWGetDisplayChanges(BYTE8 *changes,int merge);
 int HWGetScanCode(void);
 void HWWriteCharacter(WORD16 x,WORD16 y,BYTE8 ch);
 #endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		host.cpp
+//		Purpose:	Host services shared by the front ends : command line options, work done once a frame.
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sys_processor.h"
+#include "hardware.h"
+#include "host.h"
+#include "sharedmem.h"
+#include "capture.h"
+#include "console.h"
+#include "basic.h"
+#include "mathpack.h"
+#include "monitor.h"
+#include "hypercall.h"
+#include "acia.h"
+#include "tape.h"
+#include "hostfs.h"
+#include "batch.h"
+
+// *******************************************************************************************************************************
+//									Queue a text file to be typed, \n is RETURN
+// *******************************************************************************************************************************
+
+static void HOSTTypeFile(const char *fileName) {
+	FILE *f = fopen(fileName,"r");
+	if (f == NULL) { perror(fileName);exit(1); }
+	char line[256];
+	while (fgets(line,sizeof(line),f) != NULL) {
+		if (HWTypeText(line) < (int)strlen(line)) {
+			printf("%s is too long to type.\n",fileName);
+			break;
+		}
+	}
+	fclose(f);
+}
+
+// *******************************************************************************************************************************
+//		Handle the option at argv[i]. Returns the number of arguments used, 0 if it isn't one of ours.
+// *******************************************************************************************************************************
+
+int HOSTOption(int argc,char *argv[],int i) {
+	if (strcmp(argv[i],"-shm") == 0 && i+1 < argc) {								// Export state to shared memory
+		if (SHMOpen(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-output") == 0 && i+1 < argc) {							// Copy printed text to a file
+		if (CONOpenOutput(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-input") == 0 && i+1 < argc) {								// Read input from a file
+		if (CONOpenInput(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-type") == 0 && i+1 < argc) {								// Type text on the keyboard
+		HWTypeText(argv[i+1]);
+		return 2;
+	}
+	if (strcmp(argv[i],"-typefile") == 0 && i+1 < argc) {							// Type a file on the keyboard
+		HOSTTypeFile(argv[i+1]);
+		return 2;
+	}
+	if (strcmp(argv[i],"-bas") == 0 && i+1 < argc) {								// Put a BASIC program in memory
+		if (BASLoad(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-list") == 0 && i+1 < argc) {								// List the BASIC program on exit
+		BASListOnExit(argv[i+1]);
+		return 2;
+	}
+	if (strcmp(argv[i],"-listimage") == 0 && i+2 < argc) {							// List the program in an image and stop
+		exit(BASListImage(argv[i+1],argv[i+2]) ? 0 : 1);
+	}
+	if (strcmp(argv[i],"-fastmath") == 0) {										// Native floating point
+		MATHEnable();
+		return 1;
+	}
+	if (strcmp(argv[i],"-fastscreen") == 0) {										// Native scroll and clear
+		MONEnable();
+		return 1;
+	}
+	if (strcmp(argv[i],"-hypercall") == 0) {										// Host services for opcode $42
+		HYPEnable();
+		return 1;
+	}
+	if (strcmp(argv[i],"-hypercalldir") == 0 && i+1 < argc) {						// And where their files are
+		HYPSetDirectory(argv[i+1]);
+		HYPEnable();
+		return 2;
+	}
+	if (strcmp(argv[i],"-aciain") == 0 && i+1 < argc) {							// ACIA receives from a file
+		if (ACIAOpenInput(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-aciaout") == 0 && i+1 < argc) {							// ACIA sends to a file
+		if (ACIAOpenOutput(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-aciapty") == 0) {											// ACIA on a pseudo terminal
+		if (ACIAOpenTerminal() == 0) exit(1);
+		return 1;
+	}
+	if (strcmp(argv[i],"-baud") == 0 && i+1 < argc) {								// ACIA speed, 0 is unthrottled
+		ACIASetBaudRate(atoi(argv[i+1]));
+		return 2;
+	}
+	if (strcmp(argv[i],"-aciairq") == 0) {											// ACIA IRQ connected
+		ACIAEnableInterrupt();
+		return 1;
+	}
+	if (strcmp(argv[i],"-tape") == 0 && i+1 < argc) {								// Play a cassette recording
+		if (TAPEOpen(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-tapedecode") == 0 && i+2 < argc) {						// Decode a recording and stop
+		exit(TAPEDecodeFile(argv[i+1],argv[i+2]) ? 0 : 1);
+	}
+	if (strcmp(argv[i],"-tapecache") == 0 && i+1 < argc) {							// Keep decoded tapes here
+		if (TAPESetCache(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-tapeprecache") == 0 && i+1 < argc) {						// Cache a directory of tapes, stop
+		exit(TAPEPrecache(argv[i+1]) == 0 ? 0 : 1);
+	}
+	if (strcmp(argv[i],"-taperecord") == 0 && i+1 < argc) {						// Record what the ACIA sends
+		if (TAPERecord(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	if (strcmp(argv[i],"-hostfs") == 0 && i+1 < argc) {							// LOAD "x" and SAVE "x" use files
+		HFSEnable(argv[i+1]);
+		return 2;
+	}
+	if (strcmp(argv[i],"-batch") == 0 && i+1 < argc) {								// Run a program with no display
+		BATSetProgram(argv[i+1]);
+		return 2;
+	}
+	if (strcmp(argv[i],"-until") == 0 && i+1 < argc) {								// Batch ends on "ok" or "hypercall"
+		BATSetUntil(strcmp(argv[i+1],"hypercall") == 0 ? BAT_UNTIL_HYPERCALL : BAT_UNTIL_OK);
+		return 2;
+	}
+	if (strcmp(argv[i],"-cycles") == 0 && i+1 < argc) {							// Batch cycle budget
+		BATSetBudget(atoll(argv[i+1]));
+		return 2;
+	}
+	if (strcmp(argv[i],"-capture") == 0 && i+1 < argc) {							// Record the display
+		if (CAPOpen(argv[i+1]) == 0) exit(1);
+		return 2;
+	}
+	return 0;
+}
+
+// *******************************************************************************************************************************
+//							Called at the end of every frame, by whichever thread is running the emulation
+// *******************************************************************************************************************************
+
+void HOSTSync(void) {
+	SHMUpdate();
+	CAPFrame();
+	ACIASync();
+	TAPESync();
+}
+
+// *******************************************************************************************************************************
+//												Tidy up on exit
+// *******************************************************************************************************************************
+
+void HOSTEnd(void) {
+	SHMClose();
+	CAPClose();
+	CONClose();
+	BASEnd();
+	ACIAClose();
+	TAPEClose();
+}
@@ -0,0 +1,19 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		host.h
+//		Purpose:	Host services shared by the front ends (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _HOST_H
+#define _HOST_H
+
+int  HOSTOption(int argc,char *argv[],int i);
+void HOSTSync(void);
+void HOSTEnd(void);
+
+#endif
@@ -0,0 +1,102 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		hostfs.cpp
+//		Purpose:	LOAD "name" and SAVE "name" read and write host files directly
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "sys_processor.h"
+#include "basic.h"
+#include "hostfs.h"
+
+// *******************************************************************************************************************************
+//
+//		BASIC's LOAD and SAVE jump straight to the monitor entries, which just turn tape input or output on. With a
+//		quoted name after them the traps here do the whole thing at once instead : the program file, as text, is
+//		tokenised into RAM exactly as typing it would, or the program is written out as LIST would. Without a name
+//		the ROM carries on and uses the tape as before.
+//
+// *******************************************************************************************************************************
+
+static char directory[256];															// Files are in here.
+
+#define PEEKW(a) 	(CPUReadMemory(a) + (CPUReadMemory((a)+1) << 8))
+#define POKEW(a,d) 	{ CPUWriteMemory(a,(d) & 0xFF);CPUWriteMemory((a)+1,((d) >> 8) & 0xFF); }
+
+// *******************************************************************************************************************************
+//		Get the quoted name following the keyword, leaving TXTPTR after it as the statement would. Returns zero if
+//		there isn't one, -1 if it's not a usable name.
+// *******************************************************************************************************************************
+
+static int HFSGetName(char *path,int size) {
+	char name[64];
+	int p = PEEKW(BAS_TXTPTR);
+	while (CPUReadMemory(p) == ' ') p++;
+	if (CPUReadMemory(p) != '"') return 0;
+	p++;
+	int n = 0;
+	while (CPUReadMemory(p) != '"' && CPUReadMemory(p) != 0) {
+		if (n == (int)sizeof(name)-1) return -1;
+		name[n++] = CPUReadMemory(p++);
+	}
+	name[n] = '\0';
+	if (CPUReadMemory(p) == '"') p++;
+	while (CPUReadMemory(p) == ' ') p++;
+	POKEW(BAS_TXTPTR,p);
+	if (n == 0 || strchr(name,'/') != NULL || strchr(name,'\\') != NULL || name[0] == '.') return -1;
+	snprintf(path,size,"%s/%s%s",directory,name,(strchr(name,'.') == NULL) ? HFS_EXTENSION : "");
+	return 1;
+}
+
+static int HFSError(CPUSTATUS *registers,int error) {								// Go to BASIC's error report
+	registers->x = error;
+	registers->pc = BAS_ERROR;
+	return CPUTRAP_JUMP;
+}
+
+// *******************************************************************************************************************************
+//		LOAD "name". In direct mode the rest of the line carries on (e.g. LOAD "X":RUN). In a program, which has just
+//		been replaced, it carries on from the end of the new one, so it stops.
+// *******************************************************************************************************************************
+
+static int HFSLoadTrap(CPUSTATUS *registers) {
+	char path[384];
+	int found = HFSGetName(path,sizeof(path));
+	if (found == 0) return CPUTRAP_CONTINUE;										// Use the tape.
+	if (found < 0) return HFSError(registers,BAS_ERR_SYNTAX);
+	int isRunning = (CPUReadMemory(BAS_CURLIN+1) != 0xFF);
+	int result = BASLoadNow(path);
+	if (result == 0) return HFSError(registers,BAS_ERR_FUNCTION);
+	if (result < 0) return HFSError(registers,BAS_ERR_MEMORY);
+	if (isRunning) POKEW(BAS_TXTPTR,PEEKW(BAS_VARTAB)-4);							// On the last line's end.
+	return CPUTRAP_RTS;
+}
+
+// *******************************************************************************************************************************
+//												SAVE "name"
+// *******************************************************************************************************************************
+
+static int HFSSaveTrap(CPUSTATUS *registers) {
+	char path[384];
+	int found = HFSGetName(path,sizeof(path));
+	if (found == 0) return CPUTRAP_CONTINUE;
+	if (found < 0) return HFSError(registers,BAS_ERR_SYNTAX);
+	if (!BASSave(path)) return HFSError(registers,BAS_ERR_FUNCTION);
+	return CPUTRAP_RTS;
+}
+
+// *******************************************************************************************************************************
+//										Use a host directory for LOAD and SAVE
+// *******************************************************************************************************************************
+
+void HFSEnable(const char *hostDirectory) {
+	snprintf(directory,sizeof(directory),"%s",hostDirectory);
+	CPUSetTrap(HFS_LOAD,HFSLoadTrap);
+	CPUSetTrap(HFS_SAVE,HFSSaveTrap);
+}
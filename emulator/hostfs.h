@@ -0,0 +1,21 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		hostfs.h
+//		Purpose:	LOAD "name" and SAVE "name" read and write host files directly (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _HOSTFS_H
+#define _HOSTFS_H
+
+#define HFS_LOAD 		(0xFFF4)													// Monitor LOAD and SAVE entries
+#define HFS_SAVE 		(0xFFF7)
+#define HFS_EXTENSION 	".bas"														// Added to names without one
+
+void HFSEnable(const char *directory);
+
+#endif
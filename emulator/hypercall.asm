@@ -0,0 +1,79 @@
+; *******************************************************************************************************************************
+; *******************************************************************************************************************************
+;
+;		Name:		hypercall.asm
+;		Purpose:	64tass macros for calling the emulator host services (see hypercall.h)
+;		Created:	18th October 2026
+;		Author:		Paul Robson (paul@robsons.org.uk)
+;
+;		The emulator must be run with -hypercall. Each call takes the zero page address of three words P0,P1,P2
+;		and returns with carry clear if it worked, or carry set and A an error code. X and Y are preserved.
+;
+; *******************************************************************************************************************************
+; *******************************************************************************************************************************
+
+HYP_VERSION = 0 																	; A = version
+HYP_EXIT = 1 																		; Stop the emulator
+HYP_MOVE = 2 																		; Copy P2 bytes from P0 to P1 (overlap allowed)
+HYP_FILL = 3 																		; Fill P1 bytes at P0 with the low byte of P2
+HYP_MULTIPLY = 4 																	; P0:P1 = P0 * P1 (32 bit, P0 low)
+HYP_DIVIDE = 5 																		; P0 = P0 / P1, P1 = P0 % P1
+HYP_LOAD = 6 																		; Load file (name at P0, ASCIIZ) to P1, P2 = size
+HYP_SAVE = 7 																		; Save P2 bytes from P1 to file (name at P0)
+
+HYP_ERR_SERVICE = 1 																; Error codes
+HYP_ERR_DIVIDE = 2
+HYP_ERR_FILE = 3
+
+; *******************************************************************************************************************************
+;										Call service with the parameter block at block
+; *******************************************************************************************************************************
+
+hypercall .macro service,block
+		lda 	#\service
+		ldx 	#\block
+		.byte 	$42
+		.endm
+
+; *******************************************************************************************************************************
+;							Set up the parameter block then call. Immediate values or labels.
+; *******************************************************************************************************************************
+
+hypset .macro block,p0,p1,p2
+		lda 	#<\p0
+		sta 	\block+0
+		lda 	#>\p0
+		sta 	\block+1
+		lda 	#<\p1
+		sta 	\block+2
+		lda 	#>\p1
+		sta 	\block+3
+		lda 	#<\p2
+		sta 	\block+4
+		lda 	#>\p2
+		sta 	\block+5
+		.endm
+
+hypmove .macro block,from,to,count
+		#hypset \block,\from,\to,\count
+		#hypercall HYP_MOVE,\block
+		.endm
+
+hypfill .macro block,to,count,value
+		#hypset \block,\to,\count,\value
+		#hypercall HYP_FILL,\block
+		.endm
+
+hypload .macro block,name,address
+		#hypset \block,\name,\address,0
+		#hypercall HYP_LOAD,\block
+		.endm
+
+hypsave .macro block,name,start,count
+		#hypset \block,\name,\start,\count
+		#hypercall HYP_SAVE,\block
+		.endm
+
+hypexit .macro block
+		#hypercall HYP_EXIT,\block
+		.endm
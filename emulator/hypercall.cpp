@@ -0,0 +1,124 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		hypercall.cpp
+//		Purpose:	Host services for guest programs, called with opcode $42
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "sys_processor.h"
+#include "hypercall.h"
+
+#define PEEK(a) 	CPUReadMemory((a) & 0xFFFF)
+#define POKE(a,d) 	CPUWriteMemory((a) & 0xFFFF,(d) & 0xFF)
+
+static int block;																	// Zero page parameter block.
+static char directory[256] = ".";													// Files are in here.
+
+static int HYPGet(int n) {
+	return PEEK((block+n*2) & 0xFF) + (PEEK((block+n*2+1) & 0xFF) << 8);
+}
+
+static void HYPSet(int n,int value) {
+	POKE((block+n*2) & 0xFF,value);POKE((block+n*2+1) & 0xFF,value >> 8);
+}
+
+// *******************************************************************************************************************************
+//		Get the ASCIIZ file name at an address as a path in the directory. Returns zero if it is too long, or could
+//		reach outside it.
+// *******************************************************************************************************************************
+
+static int HYPFileName(int address,char *path,int size) {
+	char name[64];
+	for (int i = 0;i < (int)sizeof(name);i++) {
+		name[i] = PEEK(address+i);
+		if (name[i] == '\0') {
+			if (i == 0 || strchr(name,'/') != NULL || strchr(name,'\\') != NULL || name[0] == '.') return 0;
+			return snprintf(path,size,"%s/%s",directory,name) < size;
+		}
+	}
+	return 0;
+}
+
+// *******************************************************************************************************************************
+//								The services. Return zero if it worked, or an error code.
+// *******************************************************************************************************************************
+
+static int HYPCall(CPUSTATUS *registers) {
+	char name[384];
+	int p0 = HYPGet(0),p1 = HYPGet(1),p2 = HYPGet(2);
+	switch(registers->a) {
+		case HYP_VERSION:
+			registers->a = HYP_VERSION_NUMBER;
+			return 0;
+		case HYP_EXIT:
+			CPUExit();
+			return 0;
+		case HYP_MOVE:
+			if (p1 <= p0 || p1 >= p0 + p2) {										// Upwards is fine
+				CPUCopyMemory(p1,p0,p2);
+			} else {																// Overlaps, go down.
+				for (int i = p2-1;i >= 0;i--) POKE(p1+i,PEEK(p0+i));
+			}
+			return 0;
+		case HYP_FILL:
+			CPUFillMemory(p0,p2,p1);
+			return 0;
+		case HYP_MULTIPLY: {
+			LONG32 product = (LONG32)p0 * (LONG32)p1;
+			HYPSet(0,product & 0xFFFF);HYPSet(1,product >> 16);
+			return 0;
+		}
+		case HYP_DIVIDE:
+			if (p1 == 0) return HYP_ERR_DIVIDE;
+			HYPSet(0,p0 / p1);HYPSet(1,p0 % p1);
+			return 0;
+		case HYP_LOAD: {
+			if (!HYPFileName(p0,name,sizeof(name))) return HYP_ERR_FILE;
+			FILE *f = fopen(name,"rb");
+			if (f == NULL) return HYP_ERR_FILE;
+			int size = 0,c;
+			while (p1 + size < 0x10000 && (c = fgetc(f)) != EOF) POKE(p1+size++,c);
+			fclose(f);
+			HYPSet(2,size);
+			return 0;
+		}
+		case HYP_SAVE: {
+			if (!HYPFileName(p0,name,sizeof(name))) return HYP_ERR_FILE;
+			FILE *f = fopen(name,"wb");
+			if (f == NULL) return HYP_ERR_FILE;
+			for (int i = 0;i < p2;i++) fputc(PEEK(p1+i),f);
+			fclose(f);
+			return 0;
+		}
+	}
+	return HYP_ERR_SERVICE;
+}
+
+static void HYPHandler(CPUSTATUS *registers) {
+	block = registers->x;
+	int error = HYPCall(registers);
+	registers->carry = (error != 0);
+	if (error != 0) registers->a = error;
+}
+
+// *******************************************************************************************************************************
+//													Turn the services on
+// *******************************************************************************************************************************
+
+void HYPEnable(void) {
+	CPUSetHypercall(HYPHandler);
+}
+
+// *******************************************************************************************************************************
+//									Set the directory for HYP_LOAD and HYP_SAVE
+// *******************************************************************************************************************************
+
+void HYPSetDirectory(const char *hostDirectory) {
+	snprintf(directory,sizeof(directory),"%s",hostDirectory);
+}
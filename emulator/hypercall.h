@@ -0,0 +1,39 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		hypercall.h
+//		Purpose:	Host services for guest programs, called with opcode $42 (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _HYPERCALL_H
+#define _HYPERCALL_H
+
+#define HYP_OPCODE 		(0x42)														// Opcode, one byte.
+#define HYP_VERSION_NUMBER (1)														// Returned by HYP_VERSION
+
+//
+//		A is the service, X the zero page address of a block of three words P0,P1,P2 (low byte first). Returns
+//		with carry clear if it worked, carry set and A an error code if not. Files are in the -hypercalldir directory,
+//		the current one by default, and names can't have a / or \ in them, or start with a full stop.
+//
+#define HYP_VERSION 	(0)															// A = version
+#define HYP_EXIT 		(1)															// Stop the emulator
+#define HYP_MOVE 		(2)															// Copy P2 bytes from P0 to P1 (overlap allowed)
+#define HYP_FILL 		(3)															// Fill P1 bytes at P0 with the low byte of P2
+#define HYP_MULTIPLY 	(4)															// P0:P1 = P0 * P1 (32 bit, P0 low)
+#define HYP_DIVIDE 		(5)															// P0 = P0 / P1, P1 = P0 % P1
+#define HYP_LOAD 		(6)															// Load file (name at P0, ASCIIZ) to P1, P2 = size
+#define HYP_SAVE 		(7)															// Save P2 bytes from P1 to file (name at P0)
+
+#define HYP_ERR_SERVICE (1)															// Error codes
+#define HYP_ERR_DIVIDE 	(2)
+#define HYP_ERR_FILE 	(3)
+
+void HYPEnable(void);
+void HYPSetDirectory(const char *hostDirectory);
+
+#endif
@@ -0,0 +1,389 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		mathpack.cpp
+//		Purpose:	Native versions of the BASIC ROM floating point add, multiply and divide
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "sys_processor.h"
+#include "mathpack.h"
+
+// *******************************************************************************************************************************
+//
+//		The UK101 BASIC uses 4 byte floats : FAC is $AC (exponent) $AD-$AF (mantissa) $B0 (sign) with a rounding byte at
+//		$B9, ARG is $B3-$B7, $B8 is the sign of FAC xor ARG. These are the ROM routines translated instruction by
+//		instruction, flags included, so the results (zero page, registers and flags) are exactly what the ROM leaves.
+//		SQR, LOG, EXP, SIN etc. are series built from these, so they get faster without changing their results.
+//		Anything which would be an error (overflow, division by zero) is left to the ROM.
+//
+// *******************************************************************************************************************************
+
+#define MATH_OK 		(0)															// Returned as if by RTS
+#define MATH_ERROR 		(1)															// Would be an error, let the ROM do it
+#define MATH_POP 		(2)															// Returns from the caller too (PLA PLA)
+
+static BYTE8 zp[0x100];																// Zero page copy and registers
+static int A,X,Y,C,Z,N,V;
+
+#define NZ(r) 		{ Z = ((r) == 0);N = ((r) >> 7) & 1; }
+#define LDA(v) 		{ A = (v);NZ(A); }
+#define LDX(v) 		{ X = (v);NZ(X); }
+#define LDY(v) 		{ Y = (v);NZ(Y); }
+#define TAY() 		LDY(A)
+#define TYA() 		LDA(Y)
+#define INX() 		LDX((X + 1) & 0xFF)
+#define EOR(v) 		LDA(A ^ (v))
+#define ORA(v) 		LDA(A | (v))
+#define SBC(v) 		ADC((v) ^ 0xFF)
+#define CMP(r,v) 	{ int t = (r) - (v);C = (t >= 0);NZ(t & 0xFF); }
+#define INC(m) 		{ zp[m] = zp[m] + 1;NZ(zp[m]); }
+#define ASL(m) 		{ C = zp[m] >> 7;zp[m] = zp[m] << 1;NZ(zp[m]); }
+#define ROL(m) 		{ int t = (zp[m] << 1) | C;C = t >> 8;zp[m] = t;NZ(zp[m]); }
+#define ROR(m) 		{ int t = zp[m] | (C << 8);C = t & 1;zp[m] = t >> 1;NZ(zp[m]); }
+#define ASLA() 		{ C = A >> 7;A = (A << 1) & 0xFF;NZ(A); }
+#define ROLA() 		{ int t = (A << 1) | C;C = t >> 8;A = t & 0xFF;NZ(A); }
+#define RORA() 		{ int t = A | (C << 8);C = t & 1;A = t >> 1;NZ(A); }
+#define LSRA() 		{ C = A & 1;A = A >> 1;NZ(A); }
+
+static void ADC(int v) {															// Binary mode only.
+	int r = A + v + C;
+	V = ((~(A ^ v)) & (A ^ r) & 0x80) != 0;
+	C = (r > 0xFF);
+	LDA(r & 0xFF);
+}
+
+// *******************************************************************************************************************************
+//											$B4F1 Zero FAC, $B559 increment mantissa
+// *******************************************************************************************************************************
+
+static int MATHZero(void) {
+	LDA(0);zp[0xAC] = A;zp[0xB0] = A;
+	return MATH_OK;
+}
+
+static void MATHIncMantissa(void) {
+	INC(0xAF);if (!Z) return;
+	INC(0xAE);if (!Z) return;
+	INC(0xAD);
+}
+
+// *******************************************************************************************************************************
+//					$B528 If carry, increment the exponent and shift the mantissa right (carry in at the top)
+// *******************************************************************************************************************************
+
+static int MATHCarryIntoExponent(void) {
+	if (!C) return MATH_OK;
+	INC(0xAC);if (Z) return MATH_ERROR;												// Overflow
+	ROR(0xAD);ROR(0xAE);ROR(0xAF);ROR(0xB9);
+	return MATH_OK;
+}
+
+// *******************************************************************************************************************************
+//								$B4D5 Normalise FAC, shifting bytes then bits, adjusting the exponent
+// *******************************************************************************************************************************
+
+static int MATHNormalise(void) {
+	LDY(0);TYA();C = 0;
+	while (1) {
+		LDX(zp[0xAD]);if (!Z) break;												// Byte shifts
+		LDX(zp[0xAE]);zp[0xAD] = X;
+		LDX(zp[0xAF]);zp[0xAE] = X;
+		LDX(zp[0xB9]);zp[0xAF] = X;
+		zp[0xB9] = Y;
+		ADC(0x08);CMP(A,0x18);
+		if (Z) return MATHZero();													// Mantissa is zero.
+	}
+	while (!N) {																	// Bit shifts
+		ADC(0x01);ASL(0xB9);ROL(0xAF);ROL(0xAE);ROL(0xAD);
+	}
+	C = 1;SBC(zp[0xAC]);
+	if (C) return MATHZero();														// Underflow
+	EOR(0xFF);ADC(0x01);zp[0xAC] = A;
+	return MATHCarryIntoExponent();
+}
+
+// *******************************************************************************************************************************
+//								$B537 Negate FAC, mantissa and rounding byte twos complemented
+// *******************************************************************************************************************************
+
+static void MATHNegate(void) {
+	LDA(zp[0xB0]);EOR(0xFF);zp[0xB0] = A;
+	LDA(zp[0xAD]);EOR(0xFF);zp[0xAD] = A;
+	LDA(zp[0xAE]);EOR(0xFF);zp[0xAE] = A;
+	LDA(zp[0xAF]);EOR(0xFF);zp[0xAF] = A;
+	LDA(zp[0xB9]);EOR(0xFF);zp[0xB9] = A;
+	INC(0xB9);if (!Z) return;
+	MATHIncMantissa();
+}
+
+// *******************************************************************************************************************************
+//		Shift the 3 byte value at X+1 right A bits (A negative), the bits out go into A, $B2 fills the top. Enters at
+//		$B56B (shift a byte first), $B57B or $B592 (part way through shifting a bit)
+// *******************************************************************************************************************************
+
+#define SHIFT_BYTE 		(0)
+#define SHIFT_START 	(1)
+#define SHIFT_BIT 		(2)
+
+static void MATHShiftRight(int entry) {
+	if (entry == SHIFT_BIT) goto shiftBit;
+	if (entry == SHIFT_START) goto start;
+	shiftByte:
+		LDY(zp[(X+3) & 0xFF]);zp[0xB9] = Y;
+		LDY(zp[(X+2) & 0xFF]);zp[(X+3) & 0xFF] = Y;
+		LDY(zp[(X+1) & 0xFF]);zp[(X+2) & 0xFF] = Y;
+		LDY(zp[0xB2]);zp[(X+1) & 0xFF] = Y;
+	start:
+		ADC(0x08);
+		if (N || Z) goto shiftByte;
+		SBC(0x08);TAY();LDA(zp[0xB9]);
+		if (C) { C = 0;return; }
+	nextBit:
+		ASL((X+1) & 0xFF);
+		if (C) INC((X+1) & 0xFF);
+		ROR((X+1) & 0xFF);ROR((X+1) & 0xFF);
+	shiftBit:
+		ROR((X+2) & 0xFF);ROR((X+3) & 0xFF);RORA();
+		LDY((Y+1) & 0xFF);
+		if (!Z) goto nextBit;
+		C = 0;
+}
+
+// *******************************************************************************************************************************
+//		$B673 Add the exponents of ARG and FAC, setting the result sign. Underflow makes FAC zero and returns from the
+//		caller as well.
+// *******************************************************************************************************************************
+
+static int MATHAddExponents(void) {
+	LDA(zp[0xB3]);
+	if (Z) { MATHZero();return MATH_POP; }
+	C = 0;ADC(zp[0xAC]);
+	if (C) {
+		if (N) return MATH_ERROR;													// Overflow
+		C = 0;
+	} else {
+		if (!N) { MATHZero();return MATH_POP; }										// Underflow
+	}
+	ADC(0x80);zp[0xAC] = A;
+	if (Z) { zp[0xB0] = A;return MATH_OK; }
+	LDA(zp[0xB8]);zp[0xB0] = A;
+	return MATH_OK;
+}
+
+// *******************************************************************************************************************************
+//						$B7BA Round FAC using the top bit of the rounding byte, which is shifted out
+// *******************************************************************************************************************************
+
+static int MATHRound(void) {
+	LDA(zp[0xAC]);if (Z) return MATH_OK;
+	ASL(0xB9);if (!C) return MATH_OK;
+	MATHIncMantissa();
+	if (!Z) return MATH_OK;
+	C = 1;																			// Mantissa wrapped, $B52A.
+	return MATHCarryIntoExponent();
+}
+
+// *******************************************************************************************************************************
+//											$B73C Product to FAC, normalise
+// *******************************************************************************************************************************
+
+static int MATHResult(void) {
+	LDA(zp[0x75]);zp[0xAD] = A;
+	LDA(zp[0x76]);zp[0xAE] = A;
+	LDA(zp[0x77]);zp[0xAF] = A;
+	return MATHNormalise();
+}
+
+// *******************************************************************************************************************************
+//		$B622 Multiply ARG by the byte in A, shifting the partial product at $75 right into the rounding byte. $B627
+//		does not check for a zero byte.
+// *******************************************************************************************************************************
+
+static void MATHMultiplyByte(int checkZero) {
+	if (checkZero && Z) { LDX(0x74);MATHShiftRight(SHIFT_BYTE);return; }
+	LSRA();ORA(0x80);
+	do {
+		TAY();
+		if (C) {
+			C = 0;
+			LDA(zp[0x77]);ADC(zp[0xB6]);zp[0x77] = A;
+			LDA(zp[0x76]);ADC(zp[0xB5]);zp[0x76] = A;
+			LDA(zp[0x75]);ADC(zp[0xB4]);zp[0x75] = A;
+		}
+		ROR(0x75);ROR(0x76);ROR(0x77);ROR(0xB9);
+		TYA();LSRA();
+	} while (!Z);
+}
+
+// *******************************************************************************************************************************
+//													$B5FE FAC = ARG * FAC
+// *******************************************************************************************************************************
+
+static int MATHMultiply(void) {
+	if (Z) return MATH_OK;															// FAC is zero
+	int r = MATHAddExponents();
+	if (r != MATH_OK) return (r == MATH_POP) ? MATH_OK : r;
+	LDA(0);zp[0x75] = A;zp[0x76] = A;zp[0x77] = A;
+	LDA(zp[0xB9]);MATHMultiplyByte(1);
+	LDA(zp[0xAF]);MATHMultiplyByte(1);
+	LDA(zp[0xAE]);MATHMultiplyByte(1);
+	LDA(zp[0xAD]);MATHMultiplyByte(0);
+	return MATHResult();
+}
+
+// *******************************************************************************************************************************
+//		$B6CD FAC = ARG / FAC. Restoring division, quotient bytes go to $75-$77 (via $77,X wrapping), the last partial
+//		byte is the rounding byte.
+// *******************************************************************************************************************************
+
+static int MATHDivide(void) {
+	int pC,pZ,pN,pV;																// Flags pushed by PHP
+	if (Z) return MATH_ERROR;														// Division by zero
+	if (MATHRound() != MATH_OK) return MATH_ERROR;
+	LDA(0);C = 1;SBC(zp[0xAC]);zp[0xAC] = A;
+	int r = MATHAddExponents();
+	if (r != MATH_OK) return (r == MATH_POP) ? MATH_OK : r;
+	INC(0xAC);if (Z) return MATH_ERROR;
+	LDX(0xFD);LDA(0x01);
+	compare:
+		LDY(zp[0xB4]);CMP(Y,zp[0xAD]);
+		if (Z) {
+			LDY(zp[0xB5]);CMP(Y,zp[0xAE]);
+			if (Z) { LDY(zp[0xB6]);CMP(Y,zp[0xAF]); }
+		}
+	quotientBit:
+		pC = C;pZ = Z;pN = N;pV = V;
+		ROLA();
+		if (C) {																	// Byte of quotient complete
+			INX();zp[(0x77+X) & 0xFF] = A;
+			if (Z) {
+				LDA(0x40);
+			} else if (!N) {
+				ASLA();ASLA();ASLA();ASLA();ASLA();ASLA();
+				zp[0xB9] = A;
+				C = pC;Z = pZ;N = pN;V = pV;
+				return MATHResult();
+			} else {
+				LDA(0x01);
+			}
+		}
+		C = pC;Z = pZ;N = pN;V = pV;
+		if (C) {																	// Subtract FAC from ARG
+			TAY();
+			LDA(zp[0xB6]);SBC(zp[0xAF]);zp[0xB6] = A;
+			LDA(zp[0xB5]);SBC(zp[0xAE]);zp[0xB5] = A;
+			LDA(zp[0xB4]);SBC(zp[0xAD]);zp[0xB4] = A;
+			TYA();
+		}
+		ASL(0xB6);ROL(0xB5);ROL(0xB4);
+		if (C) goto quotientBit;
+		if (N) goto compare;
+		goto quotientBit;
+}
+
+// *******************************************************************************************************************************
+//													$B46F FAC = ARG + FAC
+// *******************************************************************************************************************************
+
+static int MATHAdd(void) {
+	if (Z) {																		// FAC is zero, ARG to FAC
+		LDA(zp[0xB7]);zp[0xB0] = A;
+		LDX(0x04);
+		do { LDA(zp[0xB2+X]);zp[0xAB+X] = A;LDX(X-1); } while (!Z);
+		zp[0xB9] = X;
+		return MATH_OK;
+	}
+	LDX(zp[0xB9]);zp[0xA3] = X;
+	LDX(0xB3);LDA(zp[0xB3]);
+	TAY();if (Z) return MATH_OK;													// ARG is zero
+	C = 1;SBC(zp[0xAC]);
+	if (!Z) {																		// Align the smaller one.
+		if (C) {
+			zp[0xAC] = Y;
+			LDY(zp[0xB7]);zp[0xB0] = Y;
+			EOR(0xFF);ADC(0x00);
+			LDY(0x00);zp[0xA3] = Y;
+			LDX(0xAC);
+		} else {
+			LDY(0x00);zp[0xB9] = Y;
+		}
+		CMP(A,0xF9);
+		if (N) {
+			MATHShiftRight(SHIFT_START);
+		} else {
+			TAY();LDA(zp[0xB9]);
+			C = zp[X+1] & 1;zp[X+1] = zp[X+1] >> 1;NZ(zp[X+1]);						// LSR $01,X
+			MATHShiftRight(SHIFT_BIT);
+		}
+	}
+	N = zp[0xB8] >> 7;V = (zp[0xB8] >> 6) & 1;Z = ((A & zp[0xB8]) == 0);			// BIT $B8
+	if (!N) {																		// Same signs, add.
+		ADC(zp[0xA3]);zp[0xB9] = A;
+		LDA(zp[0xAF]);ADC(zp[0xB6]);zp[0xAF] = A;
+		LDA(zp[0xAE]);ADC(zp[0xB5]);zp[0xAE] = A;
+		LDA(zp[0xAD]);ADC(zp[0xB4]);zp[0xAD] = A;
+		return MATHCarryIntoExponent();
+	}
+	LDY(0xAC);CMP(X,0xB3);															// Different, subtract the
+	if (!Z) LDY(0xB3);																// shifted one from the other
+	C = 1;EOR(0xFF);ADC(zp[0xA3]);zp[0xB9] = A;
+	LDA(zp[Y+3]);SBC(zp[X+3]);zp[0xAF] = A;
+	LDA(zp[Y+2]);SBC(zp[X+2]);zp[0xAE] = A;
+	LDA(zp[Y+1]);SBC(zp[X+1]);zp[0xAD] = A;
+	if (!C) MATHNegate();
+	return MATHNormalise();
+}
+
+// *******************************************************************************************************************************
+//		Run a routine on a copy of the registers and $70-$BF. If it finished, copy back and return from the ROM
+//		routine, otherwise (or if the ROM isn't the one these came from) let the ROM run it.
+// *******************************************************************************************************************************
+
+#define MATH_ZPSTART 	(0x70)
+#define MATH_ZPEND 		(0xC0)
+
+static int MATHIsStockROM(void) {
+	static int isStock = -1;
+	if (isStock < 0) {
+		LONG32 h = 2166136261U;
+		for (int a = MATH_START;a < MATH_END;a++) h = (h ^ CPUReadMemory(a)) * 16777619;
+		isStock = (h == MATH_SIGNATURE);
+		if (!isStock) printf("BASIC ROM is not the standard one, fast maths disabled.\n");
+	}
+	return isStock;
+}
+
+static int MATHCall(CPUSTATUS *registers,int (*routine)(void)) {
+	if (registers->decimal || !MATHIsStockROM()) return CPUTRAP_CONTINUE;
+	for (int i = MATH_ZPSTART;i < MATH_ZPEND;i++) zp[i] = CPUReadMemory(i);
+	A = registers->a;X = registers->x;Y = registers->y;
+	C = (registers->carry != 0);Z = (registers->zero != 0);
+	N = (registers->sign != 0);V = (registers->overflow != 0);
+	if ((*routine)() != MATH_OK) return CPUTRAP_CONTINUE;
+	for (int i = MATH_ZPSTART;i < MATH_ZPEND;i++) {
+		if (zp[i] != CPUReadMemory(i)) CPUWriteMemory(i,zp[i]);
+	}
+	registers->a = A;registers->x = X;registers->y = Y;
+	registers->carry = C;registers->zero = Z;registers->sign = N;registers->overflow = V;
+	return CPUTRAP_RTS;
+}
+
+static int MATHAddTrap(CPUSTATUS *registers) { return MATHCall(registers,MATHAdd); }
+static int MATHMultiplyTrap(CPUSTATUS *registers) { return MATHCall(registers,MATHMultiply); }
+static int MATHDivideTrap(CPUSTATUS *registers) { return MATHCall(registers,MATHDivide); }
+
+// *******************************************************************************************************************************
+//													Turn the native routines on
+// *******************************************************************************************************************************
+
+void MATHEnable(void) {
+	CPUSetTrap(MATH_FADD,MATHAddTrap);
+	CPUSetTrap(MATH_FMULT,MATHMultiplyTrap);
+	CPUSetTrap(MATH_FDIV,MATHDivideTrap);
+}
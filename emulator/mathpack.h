@@ -0,0 +1,25 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		mathpack.h
+//		Purpose:	Native versions of the BASIC ROM floating point add, multiply and divide (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _MATHPACK_H
+#define _MATHPACK_H
+
+#define MATH_FADD 		(0xB46F)													// FAC = ARG + FAC
+#define MATH_FMULT 		(0xB5FE)													// FAC = ARG * FAC
+#define MATH_FDIV 		(0xB6CD)													// FAC = ARG / FAC
+
+#define MATH_START 		(0xB44E)													// ROM range the routines are in
+#define MATH_END 		(0xB7D8)
+#define MATH_SIGNATURE 	(0x93E84791)												// FNV-1a hash of that range.
+
+void MATHEnable(void);
+
+#endif
@@ -0,0 +1,168 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		monitor.cpp
+//		Purpose:	Native scroll and clear screen for the monitor ROMs
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include "sys_processor.h"
+#include "monitor.h"
+
+// *******************************************************************************************************************************
+//
+//		Each trap checks the code at its address is the routine it replaces, so whichever monitor is loaded only its own
+//		routines are run natively. The memory, zero page and registers are left as the ROM code leaves them.
+//
+// *******************************************************************************************************************************
+
+#define PEEK(a) 	CPUReadMemory(a)
+#define POKE(a,d) 	CPUWriteMemory(a,(d) & 0xFF)
+#define PEEKW(a) 	(PEEK(a) + (PEEK((a)+1) << 8))
+
+static const BYTE8 cegmonScroll[] = {												// $F89E-$F8CE
+	0x20,0x28,0xFE,0x20,0xD1,0xFF,0x20,0xEE,0xFD,0xAE,0x22,0x02,0x20,0x27,0x02,0x10,
+	0xFB,0xE8,0x20,0xEE,0xFD,0xA2,0x03,0x20,0xEE,0xFD,0x20,0xCF,0xFB,0x90,0xED,0xA9,
+	0x20,0x20,0x2A,0x02,0x10,0xFB,0xA2,0x01,0xBD,0x23,0x02,0x9D,0x28,0x02,0xCA,0x10,
+	0xF7
+};
+static const BYTE8 cegmonClear[] = {												// $FE59-$FE6F
+	0xA0,0x00,0x84,0xF9,0xA9,0xD0,0x85,0xFA,0xA2,0x08,0xA9,0x20,0x91,0xF9,0xC8,0xD0,
+	0xFB,0xE6,0xFA,0xCA,0xD0,0xF6,0x60
+};
+static const BYTE8 monitor2Scroll[] = {												// $FB60-$FB8C
+	0xA2,0xD4,0xA0,0x00,0x84,0xE3,0xA9,0xD0,0x85,0xE4,0x85,0xE6,0xA9,0x40,0x85,0xE5,
+	0xB1,0xE5,0x91,0xE3,0xC8,0xD0,0xF9,0xE6,0xE4,0xE6,0xE6,0xE4,0xE6,0xD0,0xF1,0xA2,
+	0x40,0xA9,0x20,0x9D,0xBF,0xD3,0xCA,0xD0,0xFA,0xCE,0x08,0x02,0x60
+};
+static const BYTE8 monitor2Clear[] = {												// $FB22-$FB39
+	0xA0,0x00,0x84,0xE3,0xA9,0xD0,0x85,0xE4,0xA9,0x20,0xA2,0xD4,0x91,0xE3,0xC8,0xD0,
+	0xFB,0xE6,0xE4,0xE4,0xE4,0xD0,0xF5,0x60
+};
+static const BYTE8 wemonScroll[] = {												// $F28D-$F2AF
+	0xA0,0x40,0xA2,0xCF,0xA9,0x40,0x85,0xF8,0xE8,0x86,0xF9,0x86,0xF7,0xB1,0xF8,0x91,
+	0xF6,0xC8,0xD0,0xF9,0xE0,0xD3,0xD0,0xF0,0xA9,0x60,0x88,0x91,0xF6,0x88,0xC0,0xC0,
+	0xD0,0xF9,0x60
+};
+static const BYTE8 wemonClear[] = {													// $F0A2-$F0C5
+	0xA9,0x60,0xA0,0x00,0x8D,0x01,0x02,0x99,0x00,0xD3,0x99,0x00,0xD2,0x99,0x00,0xD1,
+	0x99,0x00,0xD0,0xC8,0xD0,0xF1,0xA9,0xD0,0x8D,0x25,0x02,0x85,0xF7,0xA0,0xCB,0x8C,
+	0x00,0x02,0xD0,0x48
+};
+
+static int MONMatches(WORD16 address,const BYTE8 *code,int size) {
+	for (int i = 0;i < size;i++) if (PEEK(address+i) != code[i]) return 0;
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//		CEGMON scroll, of the window at $0223 (top line) to $0225 (bottom line), $0222+1 wide. Lines are copied by code
+//		at $0227 in RAM, which must be the usual LDA abs,X / STA abs,X / DEX / RTS. Carries on at $F8CF.
+// *******************************************************************************************************************************
+
+static int MONCegmonScroll(CPUSTATUS *registers) {
+	if (!MONMatches(MON_CEGMON_SCROLL,cegmonScroll,sizeof(cegmonScroll))) return CPUTRAP_CONTINUE;
+	if (PEEK(0x227) != 0xBD || PEEK(0x22A) != 0x9D || PEEK(0x22D) != 0xCA || PEEK(0x22E) != 0x60) return CPUTRAP_CONTINUE;
+	int width = PEEK(0x222)+1,top = PEEKW(0x223),bottom = PEEKW(0x225);
+	if (width > 0x40 || bottom <= top || ((bottom - top) & 0x3F) != 0) return CPUTRAP_CONTINUE;
+
+	int low = PEEK(0x231),high = (PEEK(0x232) - (low < 0x40)) & 0xFF;				// $FE28 line pointer up, wraps.
+	POKE(0x231,low - 0x40);POKE(0x232,(high == 0xCF) ? 0xD7 : high);
+
+	int to = top;																	// Move lines up, blank the last.
+	do {
+		CPUCopyMemory(to,to+0x40,width);
+		to += 0x40;
+	} while (to < bottom);
+	CPUFillMemory(to,0x20,width);
+
+	POKE(0x228,top);POKE(0x229,top >> 8);											// Copy code pointers.
+	POKE(0x22B,to);POKE(0x22C,to >> 8);
+
+	int borrow = (to & 0xFF) < (bottom & 0xFF);										// Flags from $FBCF's compare
+	int result = (to >> 8) - (bottom >> 8) - borrow;
+	registers->overflow = (((to >> 8) ^ (bottom >> 8)) & ((to >> 8) ^ result) & 0x80) != 0;
+	registers->a = top & 0xFF;registers->x = 0xFF;
+	registers->carry = 1;registers->zero = 0;registers->sign = 1;
+	registers->pc = 0xF8CF;
+	return CPUTRAP_JUMP;
+}
+
+// *******************************************************************************************************************************
+//							CEGMON clear screen, fills $D000-$D7FF (only video RAM is there) with spaces
+// *******************************************************************************************************************************
+
+static int MONCegmonClear(CPUSTATUS *registers) {
+	if (!MONMatches(MON_CEGMON_CLEAR,cegmonClear,sizeof(cegmonClear))) return CPUTRAP_CONTINUE;
+	CPUFillMemory(0xD000,0x20,0x401);
+	POKE(0xF9,0x00);POKE(0xFA,0xD8);
+	registers->a = 0x20;registers->x = 0;registers->y = 0;
+	registers->zero = 1;registers->sign = 0;
+	return CPUTRAP_RTS;
+}
+
+// *******************************************************************************************************************************
+//								monitor2 scroll all 16 lines up, clear the bottom one, decrement $0208
+// *******************************************************************************************************************************
+
+static int MONMonitor2Scroll(CPUSTATUS *registers) {
+	if (!MONMatches(MON_MONITOR2_SCROLL,monitor2Scroll,sizeof(monitor2Scroll))) return CPUTRAP_CONTINUE;
+	CPUCopyMemory(0xD000,0xD040,0x3C0);
+	CPUFillMemory(0xD3C0,0x20,0x40);
+	POKE(0xE3,0x00);POKE(0xE4,0xD4);POKE(0xE5,0x40);POKE(0xE6,0xD4);
+	int line = (PEEK(0x208) - 1) & 0xFF;
+	POKE(0x208,line);
+	registers->a = 0x20;registers->x = 0;registers->y = 0;
+	registers->carry = 1;registers->zero = (line == 0);registers->sign = (line >> 7);
+	return CPUTRAP_RTS;
+}
+
+static int MONMonitor2Clear(CPUSTATUS *registers) {
+	if (!MONMatches(MON_MONITOR2_CLEAR,monitor2Clear,sizeof(monitor2Clear))) return CPUTRAP_CONTINUE;
+	CPUFillMemory(0xD000,0x20,0x400);
+	POKE(0xE3,0x00);POKE(0xE4,0xD4);
+	registers->a = 0x20;registers->x = 0xD4;registers->y = 0;
+	registers->carry = 1;registers->zero = 1;registers->sign = 0;
+	return CPUTRAP_RTS;
+}
+
+// *******************************************************************************************************************************
+//		WEMON scroll, the top line stays (and column 0 of the last line, $D3C0), $60 is its space. Needs ($F6) on a page.
+// *******************************************************************************************************************************
+
+static int MONWemonScroll(CPUSTATUS *registers) {
+	if (!MONMatches(MON_WEMON_SCROLL,wemonScroll,sizeof(wemonScroll)) || PEEK(0xF6) != 0) return CPUTRAP_CONTINUE;
+	CPUCopyMemory(0xD040,0xD080,0x3C0);
+	CPUFillMemory(0xD3C1,0x60,0x3F);
+	POKE(0xF7,0xD3);POKE(0xF8,0x40);POKE(0xF9,0xD3);
+	registers->a = 0x60;registers->x = 0xD3;registers->y = 0xC0;
+	registers->carry = 1;registers->zero = 1;registers->sign = 0;
+	return CPUTRAP_RTS;
+}
+
+static int MONWemonClear(CPUSTATUS *registers) {									// Carries on at $F10E
+	if (!MONMatches(MON_WEMON_CLEAR,wemonClear,sizeof(wemonClear))) return CPUTRAP_CONTINUE;
+	CPUFillMemory(0xD000,0x60,0x400);
+	POKE(0x201,0x60);POKE(0x225,0xD0);POKE(0xF7,0xD0);POKE(0x200,0xCB);
+	registers->a = 0xD0;registers->y = 0xCB;
+	registers->zero = 0;registers->sign = 1;
+	registers->pc = 0xF10E;
+	return CPUTRAP_JUMP;
+}
+
+// *******************************************************************************************************************************
+//													Turn the native routines on
+// *******************************************************************************************************************************
+
+void MONEnable(void) {
+	CPUSetTrap(MON_CEGMON_SCROLL,MONCegmonScroll);
+	CPUSetTrap(MON_CEGMON_CLEAR,MONCegmonClear);
+	CPUSetTrap(MON_MONITOR2_SCROLL,MONMonitor2Scroll);
+	CPUSetTrap(MON_MONITOR2_CLEAR,MONMonitor2Clear);
+	CPUSetTrap(MON_WEMON_SCROLL,MONWemonScroll);
+	CPUSetTrap(MON_WEMON_CLEAR,MONWemonClear);
+}
@@ -0,0 +1,24 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		monitor.h
+//		Purpose:	Native scroll and clear screen for the monitor ROMs (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _MONITOR_H
+#define _MONITOR_H
+
+#define MON_CEGMON_SCROLL 	(0xF89E)												// CEGMON (monitor_rom.inc)
+#define MON_CEGMON_CLEAR 	(0xFE59)
+#define MON_MONITOR2_SCROLL (0xFB60)												// monitor2_rom.inc
+#define MON_MONITOR2_CLEAR 	(0xFB22)
+#define MON_WEMON_SCROLL 	(0xF28D)												// WEMON (wemon_rom.inc)
+#define MON_WEMON_CLEAR 	(0xF0A2)
+
+void MONEnable(void);
+
+#endif
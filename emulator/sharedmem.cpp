@@ -0,0 +1,81 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		sharedmem.cpp
+//		Purpose:	Live video RAM and CPU state exported through POSIX shared memory
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "sys_processor.h"
+#include "sharedmem.h"
+
+#ifdef LINUX
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+static SHMEXPORT *shm = NULL;														// Mapped segment, NULL if not exporting
+static char shmName[256];
+static LONG32 frames = 0;
+
+// *******************************************************************************************************************************
+//							Create (or reuse) the segment and map it. Returns zero on failure.
+// *******************************************************************************************************************************
+
+int SHMOpen(const char *name) {
+	snprintf(shmName,sizeof(shmName),"%s%s",(name[0] == '/') ? "" : "/",name);		// Names start with /
+	int fd = shm_open(shmName,O_CREAT|O_RDWR,0644);
+	if (fd < 0) { perror(shmName);return 0; }
+	if (ftruncate(fd,sizeof(SHMEXPORT)) != 0) { perror(shmName);close(fd);return 0; }
+	void *map = mmap(NULL,sizeof(SHMEXPORT),PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+	close(fd);																		// Mapping keeps it open.
+	if (map == MAP_FAILED) { perror(shmName);return 0; }
+	shm = (SHMEXPORT *)map;
+	memset(shm,0,sizeof(SHMEXPORT));
+	shm->version = SHM_VERSION;
+	__atomic_store_n(&shm->magic,SHM_MAGIC,__ATOMIC_RELEASE);						// Valid from now on.
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//		Once a frame, from the thread running the emulation. Sequence goes odd, the data is copied, then it goes even.
+// *******************************************************************************************************************************
+
+void SHMUpdate(void) {
+	if (shm == NULL) return;
+	LONG32 seq = shm->sequence;
+	__atomic_store_n(&shm->sequence,seq+1,__ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);										// Odd is seen before the data.
+	shm->frame = ++frames;
+	shm->status = *CPUGetStatus();
+	for (int i = 0;i < 1024;i++) shm->video[i] = CPUReadMemory(0xD000+i);
+	__atomic_store_n(&shm->sequence,seq+2,__ATOMIC_RELEASE);						// Data is seen before even.
+}
+
+// *******************************************************************************************************************************
+//								Remove the segment, so viewers don't watch a stopped emulator
+// *******************************************************************************************************************************
+
+void SHMClose(void) {
+	if (shm == NULL) return;
+	munmap(shm,sizeof(SHMEXPORT));
+	shm_unlink(shmName);
+	shm = NULL;
+}
+
+#else
+
+int SHMOpen(const char *name) {
+	printf("Shared memory export is not supported on this platform.\n");
+	return 0;
+}
+void SHMUpdate(void) {}
+void SHMClose(void) {}
+
+#endif
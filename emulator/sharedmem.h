@@ -0,0 +1,54 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		sharedmem.h
+//		Purpose:	Live video RAM and CPU state exported through POSIX shared memory (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _SHAREDMEM_H
+#define _SHAREDMEM_H
+
+#define SHM_MAGIC 		(0x31303155)												// "UK10" little endian
+#define SHM_VERSION 	(1)
+
+// *******************************************************************************************************************************
+//
+//		Layout of the segment (/dev/shm/<name>). Written once a frame under a sequence lock : sequence is odd while
+//		it is being written. A viewer reads it in place :
+//
+//			do {
+//				seq = SHMReadBegin(shm);
+//				... read frame, status, video ...
+//			} while (SHMReadRetry(shm,seq));
+//
+// *******************************************************************************************************************************
+
+typedef struct __SHMEXPORT {
+	LONG32 magic;																	// SHM_MAGIC
+	LONG32 version;																	// SHM_VERSION
+	LONG32 sequence;																// Sequence lock, odd when updating.
+	LONG32 frame;																	// Frames completed.
+	CPUSTATUS status;																// Registers at end of frame
+	BYTE8 video[1024];																// Copy of $D000-$D3FF
+} SHMEXPORT;
+
+static inline LONG32 SHMReadBegin(const SHMEXPORT *shm) {
+	LONG32 seq;
+	while ((seq = __atomic_load_n(&shm->sequence,__ATOMIC_ACQUIRE)) & 1) {}			// Wait for a write to finish.
+	return seq;
+}
+
+static inline int SHMReadRetry(const SHMEXPORT *shm,LONG32 seq) {
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);										// Reads done before checking.
+	return __atomic_load_n(&shm->sequence,__ATOMIC_RELAXED) != seq;
+}
+
+int  SHMOpen(const char *name);
+void SHMUpdate(void);
+void SHMClose(void);
+
+#endif
@@ -14,6 +14,7 @@
 #ifndef _DEBUG_SYS_H
 #define _DEBUG_SYS_H
 #include "sys_processor.h"
+#include "hardware.h"
 
 #define WIN_TITLE 		"UK101 Emulator"											// Initial Window stuff
 #define WIN_WIDTH		(32*8*4)
@@ -24,10 +25,14 @@
 //							These functions need to be implemented by the dependent debugger.
 // *******************************************************************************************************************************
 
-#define DEBUG_ARGUMENTS(ac,av) { if (ac >= 2) CPULoadBinary(argv[1]); }
+#define DEBUG_ARGUMENTS(ac,av) DBGXArguments(ac,av)								// Process command line, returns auto start.
 
-#define DEBUG_CPURENDER(x) 	DBGXRender(x,0)											// Render the debugging display
-#define DEBUG_VDURENDER(x)	DBGXRender(x,1)											// Render the game display etc.
+#define DEBUG_CPURENDER(x) 	DBGXRender(x,NULL)										// Render the debugging display
+#define DEBUG_VDURENDER(x,s) DBGXRender(x,s)										// Render the game display from a snapshot.
+
+#define DEBUG_SNAPSHOT 		CPUSNAPSHOT												// State published by the emulation thread each frame.
+#define DEBUG_TAKESNAPSHOT(s,m) CPUGetSnapshot(s,m)									// Take a snapshot (emulation thread, or stopped)
+#define DEBUG_DISPLAYRATE	(60)													// Display update rate when running.
 
 #define DEBUG_RESET() 		CPUReset()												// Reset the CPU / Hardware.
 #define DEBUG_HOMEPC()		((CPUGetStatus()->pc) & 0xFFFF) 						// Get PC Home Address (e.g. current PCTR value)
@@ -40,8 +45,12 @@
 #define DEBUG_SHIFT(d,v)	((((d) << 4) | v) & 0xFFFF)								// Shifting into displayed address.
 
 #define DEBUG_KEYMAP(k,r)	(k)
+#define DEBUG_KEYEVENT(k,d)	HWKeyboardEvent(k,d)									// Key pressed or released, update matrix.
 
-void DBGXRender(int *address,int isRunMode);										// Render the debugger screen.
+#ifdef INCLUDE_DEBUGGING_SUPPORT
+void DBGXRender(int *address,CPUSNAPSHOT *display);								// Render the debugger screen or display.
+#endif
+int DBGXArguments(int argc,char *argv[]);											// Handle the command line.
 BYTE8 DRVGFXHandler(BYTE8 key,BYTE8 isRunMode);
 
 #endif
@@ -19,6 +19,8 @@
 
 #include "6502/__6502mnemonics.h"
 
+#include "video.h"
+#include "host.h"
 #include "character_rom.inc"
 
 #define DBGC_ADDRESS 	(0x0F0)														// Colour scheme.
@@ -26,6 +28,22 @@
 #define DBGC_HIGHLIGHT 	(0xFF0)
 
 static int renderCount = 0;
+static LONG32 panelSignature = 0;													// Hash of what the debugger panel shows.
+
+static void DBGXRenderDisplay(CPUSNAPSHOT *display);
+static void DBGXBuildAtlas(int size,int colour);
+static void DBGXBenchmark(void);
+static void DBGXDrawPixels(SDL_Rect *cell,int ch,int size);
+static LONG32 DBGXPanelSignature(int *address);
+
+#define RENDER_PIXELS 	(0)															// One rectangle per pixel (for comparison)
+#define RENDER_ATLAS 	(1)															// One blit per character from the atlas
+#define RENDER_EXPAND 	(2)															// Expand ROM straight into 32 bit pixels
+
+static int renderMethod = RENDER_EXPAND;											// Preferred method, falls back to atlas.
+
+static SDL_Surface *glyphAtlas = NULL;												// All 256 characters, pre-rendered
+static int atlasSize,atlasColour;													// Scale and colour of the atlas.
 
 // *******************************************************************************************************************************
 //											This renders the debug screen
@@ -33,7 +51,18 @@ static int renderCount = 0;
 
 static const char *labels[] = { "A","X","Y","PC","SP","SR","CY","N","V","B","D","I","Z","C", NULL };
 
-void DBGXRender(int *address,int showDisplay) {
+void DBGXRender(int *address,CPUSNAPSHOT *display) {
+
+	if (display != NULL) {															// Showing the display from a snapshot
+		DBGXRenderDisplay(display);
+		return;
+	}
+
+	LONG32 signature = DBGXPanelSignature(address);								// Only redraw if something changed
+	GFXRetainFrame();
+	if (!GFXIsFullRedraw() && signature == panelSignature) return;
+	GFXRedrawAll();
+	panelSignature = signature;
 
 	int n = 0;
 	char buffer[32];
@@ -91,15 +120,44 @@ void DBGXRender(int *address,int showDisplay) {
 		}
 		GFXString(GRID(5,row),buffer,GRIDSIZE,isPC ? DBGC_HIGHLIGHT:DBGC_DATA,-1);	// Print the mnemonic
 	}
+}	
+
+// *******************************************************************************************************************************
+//		FNV-1a hash of everything the debugger panel shows : registers, the settings, the bytes dumped and disassembled.
+// *******************************************************************************************************************************
+
+#define FNV(h,v) 	(h) = ((h) ^ (LONG32)(v)) * 16777619
 
+static LONG32 DBGXPanelSignature(int *address) {
+	LONG32 h = 2166136261;
+	CPUSTATUS *s = CPUGetStatus();
+	FNV(h,s->a);FNV(h,s->x);FNV(h,s->y);FNV(h,s->pc);FNV(h,s->sp);FNV(h,s->status);FNV(h,s->cycles);
+	FNV(h,s->sign);FNV(h,s->overflow);FNV(h,s->brk);FNV(h,s->decimal);FNV(h,s->interruptDisable);
+	FNV(h,s->zero);FNV(h,s->carry);
+	for (int i = 0;i < 4;i++) FNV(h,address[i]);
+	for (int i = 0;i < 64;i++) FNV(h,CPUReadMemory((address[1]+i) & 0xFFFF));	// Memory dump
+	for (int i = 0;i < 14*3;i++) FNV(h,CPUReadMemory((address[0]+i) & 0xFFFF));	// Most code shown
+	FNV(h,GFXWidth());FNV(h,GFXHeight());
+	return h;
+}
+
+// *******************************************************************************************************************************
+//						Render the 48x16 display. This only uses the snapshot, so it is safe while running
+// *******************************************************************************************************************************
+
+static void DBGXRenderDisplay(CPUSNAPSHOT *display) {
 	int xs = 48;
 	int ys = 16;
-	if (showDisplay) {
-		renderCount++;
-		int size = 2;
-		int x1 = WIN_WIDTH/2-xs*size*8/2;
-		int y1 = WIN_HEIGHT/2-ys*size*16/2;
-		int cursorPos = 0;
+	renderCount++;
+	panelSignature = 0;																// Debugger panel will need redrawing
+	int size = (GFXWidth()-16) / VID_WIDTH;											// Largest scale that fits with a border
+	if ((GFXHeight()-16) / VID_HEIGHT < size) size = (GFXHeight()-16) / VID_HEIGHT;
+	if (size < 1) size = 1;
+	int x1 = GFXWidth()/2-xs*size*8/2;
+	int y1 = GFXHeight()/2-ys*size*16/2;
+	GFXRetainFrame();																// Only redraw what changes.
+	int isFull = GFXIsFullRedraw();
+	if (isFull) {																	// Draw the frame if starting again
 		SDL_Rect r;
 		int b = 8;
 		r.x = x1-b;r.y = y1-b;r.w = xs*size*8+b*2;r.h=ys*size*16+b*2;
@@ -107,29 +165,146 @@ void DBGXRender(int *address,int showDisplay) {
 		b = b - 4;
 		r.x = x1-b;r.y = y1-b;r.w = xs*size*8+b*2;r.h=ys*size*16+b*2;
 		GFXRectangle(&r,0);
-		for (int x = 0;x < xs;x++) 
-		{
-			for (int y = 0;y < ys;y++)
-		 	{
-		 		int ch = CPUReadMemory(0xD00C+x+y*64);
-		 		ch = ch & 0xFF;
-		 		int xc = x1 + x * 8 * size;
-		 		int yc = y1 + y * 16 * size;
-		 		SDL_Rect rc;
-		 		int cp = ch * 8;
-		 		int col = 0xF80;
-		 		rc.w = size;rc.h = size*2;														// Width and Height of pixel.
-		 		for (int x = 0;x < 8;x++) {														// 5 Across
-		 			rc.x = xc + x * size;
-		 			for (int y = 0;y < 8;y++) {													// 7 Down
-		 				int f = character_rom[cp+y];
-		 				rc.y = yc + y * size * 2;
-		 				if (f & (0x80 >> x)) {		
-		 					GFXRectangle(&rc,col);			
-		 				}
-		 			}
-		 		}
+	}
+	int pitch;																		// Expanding doesn't clip, so it fits.
+	Uint32 *pixels = (renderMethod == RENDER_EXPAND && x1 >= 0 && y1 >= 0) ? GFXLockPixels(&pitch) : NULL;
+	Uint32 foreground = GFXColour(0xF80),background = GFXColour(0);
+	if (pixels == NULL) DBGXBuildAtlas(size,0xF80);									// Glyphs at this scale and colour.
+	SDL_Rect from,to,changed;
+	from.w = 8 * size;from.h = 16 * size;
+	for (int y = 0;y < ys;y++) 
+	{
+		changed.w = 0;																// Changed run of cells on this line
+		for (int x = 0;x < xs;x++)
+	 	{
+	 		int offset = 0x00C+x+y*64;
+	 		if (isFull || (display->changed[offset >> 3] & (1 << (offset & 7)))) {
+		 		int ch = display->video[offset];									// One blit per character
+		 		from.x = (ch & 0x0F) * from.w;from.y = (ch >> 4) * from.h;
+		 		to.x = x1 + x * 8 * size;to.y = y1 + y * 16 * size;					// (Atlas and pixels clip)
+		 		to.w = from.w;to.h = from.h;
+		 		if (changed.w == 0) changed = to;
+		 		changed.w = to.x + from.w - changed.x;
+		 		if (pixels != NULL) {												// Expand straight into the pixels
+		 			VIDDrawCharacter(pixels+to.y*pitch+to.x,pitch,ch,size,foreground,background);
+		 		} else if (renderMethod == RENDER_PIXELS) {
+		 			DBGXDrawPixels(&to,ch,size);
+		 		} else {
+			 		GFXBlit(glyphAtlas,&from,&to);
+			 	}
+		 	} else if (changed.w != 0) {
+		 		GFXDamage(&changed);
+		 		changed.w = 0;
 		 	}
+	 	}
+	 	if (changed.w != 0) GFXDamage(&changed);
+	}
+	if (pixels != NULL) GFXUnlockPixels();
+	for (int i = 0;i < 1024/8;i++) display->changed[i] = 0;						// Drawn now, if shown again no change.
+}
+
+// *******************************************************************************************************************************
+//							The original renderer, a rectangle for each pixel. Kept for comparison.
+// *******************************************************************************************************************************
+
+static void DBGXDrawPixels(SDL_Rect *cell,int ch,int size) {
+	SDL_Rect rc = *cell;
+	GFXRectangle(&rc,0);
+	rc.w = size;rc.h = size*2;														// Width and Height of pixel.
+	for (int x = 0;x < 8;x++) {
+		rc.x = cell->x + x * size;
+		for (int y = 0;y < 8;y++) {
+			rc.y = cell->y + y * size * 2;
+			if (character_rom[ch*8+y] & (0x80 >> x)) GFXRectangle(&rc,0xF80);
 		}
 	}
-}	
+}
+
+// *******************************************************************************************************************************
+//		Draw all 256 characters from character_rom into a 16x16 atlas, each row doubled vertically. Only redone if the
+//		scale or colour changes.
+// *******************************************************************************************************************************
+
+static void DBGXBuildAtlas(int size,int colour) {
+	if (glyphAtlas != NULL && size == atlasSize && colour == atlasColour) return;
+	if (glyphAtlas != NULL) SDL_FreeSurface(glyphAtlas);
+	atlasSize = size;atlasColour = colour;
+	glyphAtlas = GFXCreateSurface(16*8*size,16*16*size);
+	GFXSurfaceRectangle(glyphAtlas,NULL,0);
+	SDL_Rect rc;
+	rc.w = size;rc.h = size*2;														// Width and Height of pixel.
+	for (int ch = 0;ch < 256;ch++) {
+		int xc = (ch & 0x0F) * 8 * size;
+		int yc = (ch >> 4) * 16 * size;
+		for (int y = 0;y < 8;y++) {
+			int f = character_rom[ch*8+y];
+			rc.y = yc + y * size * 2;
+			for (int x = 0;x < 8;x++) {
+				rc.x = xc + x * size;
+				if (f & (0x80 >> x)) GFXSurfaceRectangle(glyphAtlas,&rc,colour);
+			}
+		}
+	}
+}
+
+// *******************************************************************************************************************************
+//					Handle the command line. Returns non zero if the emulator should start running.
+// *******************************************************************************************************************************
+
+int DBGXArguments(int argc,char *argv[]) {
+	int files = 0;
+	int scale = 2,vsync = 0;
+	for (int i = 1;i < argc;i++) {
+		if (strcmp(argv[i],"-benchmark") == 0) {									// Time the display renderers
+			DBGXBenchmark();
+			exit(0);
+		}
+		if (strcmp(argv[i],"-scale") == 0 && i+1 < argc) {							// Window pixels per pixel, 0 = none
+			scale = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i],"-vsync") == 0) {
+			vsync = 1;
+			continue;
+		}
+		int used = HOSTOption(argc,argv,i);											// Options common to all front ends.
+		if (used != 0) {
+			i += used-1;
+			continue;
+		}
+		if (strcmp(argv[i],"-cpuusage") == 0) {										// Report host CPU stopped/running
+			DBGMeasureCPU();
+			continue;
+		}
+		if (files == 0) CPULoadBinary(argv[i]);										// First is a memory image
+		files++;																	// Second means run it
+	}
+	int asked = scale;																// The surface must hold the display
+	while (scale > 1 && (WIN_WIDTH/scale < VID_WIDTH+16 || WIN_HEIGHT/scale < VID_HEIGHT+16)) scale--;
+	if (scale != asked) printf("-scale %d is too large for the display, using %d.\n",asked,scale);
+	GFXSetPresentation(scale,vsync);
+	return (files == 2);
+}
+
+// *******************************************************************************************************************************
+//		Render a full display of every character with each method, off screen, and report the frames per second
+// *******************************************************************************************************************************
+
+static void DBGXBenchmark(void) {
+	static const char *names[] = { "Rectangle per pixel","Glyph atlas blit","Character ROM expansion" };
+	CPUSNAPSHOT snapshot;
+	GFXOpenOffscreen(WIN_WIDTH,WIN_HEIGHT);											// Always a full redraw.
+	CPUGetSnapshot(&snapshot,0);													// Reset fills the screen with junk.
+	for (int method = RENDER_PIXELS;method <= RENDER_EXPAND;method++) {
+		renderMethod = method;
+		int frames = 0;
+		Uint64 start = SDL_GetPerformanceCounter();
+		Uint64 elapsed = 0;
+		while (elapsed < SDL_GetPerformanceFrequency() * 2) {						// Run for two seconds.
+			DBGXRenderDisplay(&snapshot);
+			frames++;
+			elapsed = SDL_GetPerformanceCounter() - start;
+		}
+		printf("%-24s %10.1f fps\n",names[method],(double)frames * SDL_GetPerformanceFrequency() / elapsed);
+	}
+}
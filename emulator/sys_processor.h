@@ -35,13 +35,36 @@ typedef struct __CPUSTATUS {
 	int cycles;				
 } CPUSTATUS;
 
+typedef struct __CPUSNAPSHOT {
+	CPUSTATUS status;																// Registers at end of frame
+	BYTE8 video[1024];																// Copy of $D000-$D3FF
+	BYTE8 changed[1024/8];															// Bit per video byte changed since last snapshot
+	LONG32 frame;																	// Frames executed since start
+} CPUSNAPSHOT;
+
+#define CPUTRAP_CONTINUE 	(0)														// Trap handler results.
+#define CPUTRAP_RTS 		(1)
+#define CPUTRAP_JUMP 		(2)
+
+typedef int (*CPUTRAPHANDLER)(CPUSTATUS *registers);
+typedef void (*CPUHYPERCALL)(CPUSTATUS *registers);
+typedef int (*CPUINTERRUPT)(void);
+
 CPUSTATUS *CPUGetStatus(void);
+void CPUSetTrap(WORD16 address,CPUTRAPHANDLER handler);
+void CPUSetHypercall(CPUHYPERCALL handler);
+void CPUSetInterruptSource(CPUINTERRUPT source);
+LONG32 CPUGetClock(void);
+void CPUGetSnapshot(CPUSNAPSHOT *snapshot,int merge);
 BYTE8 CPUExecute(WORD16 breakPoint1,WORD16 breakPoint2);
 WORD16 CPUGetStepOverBreakpoint(void);
 void CPUWriteMemory(WORD16 address,BYTE8 data);
+void CPUCopyMemory(WORD16 to,WORD16 from,int count);
+void CPUFillMemory(WORD16 to,BYTE8 data,int count);
 void CPUEndRun(void);
 void CPULoadBinary(char *fileName);
 void CPUExit(void);
+int CPUHasExited(void);
 
 #endif
 #endif
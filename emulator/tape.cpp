@@ -0,0 +1,560 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		tape.cpp
+//		Purpose:	Kansas City Standard cassette recordings (WAV) decoded for the ACIA, and made from what it sends
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <strings.h>
+#include <thread>
+#include <chrono>
+#include "sys_processor.h"
+#include "handoff.h"
+#include "acia.h"
+#include "tape.h"
+
+#ifdef LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+typedef struct __TAPEFILE {															// A file in memory
+	BYTE8 *data;
+	long size;
+	int isMapped;
+} TAPEFILE;
+
+typedef struct __TAPEDECODER {														// One recording being decoded
+	char name[256];
+	TAPEFILE wav;
+	const BYTE8 *samples;															// First sample in the data chunk
+	long sampleCount;																// Number of sample frames.
+	int sampleRate,sampleBits,frameSize;											// Frame is all channels.
+	long position;																	// Next sample frame to decode
+	int level;																		// Current side of zero, +1 or -1
+	long lastCrossing;																// Sample of the last crossing.
+	int inFrame,bitNumber,shifter;													// Character being received
+	double bitSample,bitLength;														// Sample of next bit, samples per bit
+	BYTE8 pending[256];																// Characters decoded, not yet taken
+	int pendingCount,pendingPosition;
+	long decoded;																	// Statistics
+	double decodeTime;
+	int isReported;
+} TAPEDECODER;
+
+static TAPEDECODER player;															// The tape being played
+static TAPEFILE cached;																// Its decoded bytes, if from the cache
+static long cachedPosition;
+static char cacheDirectory[TAPE_MAXPATH] = "";										// Empty if not caching.
+
+// *******************************************************************************************************************************
+//												Host time in seconds
+// *******************************************************************************************************************************
+
+static double TAPETime(void) {
+	#ifdef LINUX
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC,&t);
+	return t.tv_sec + t.tv_nsec / 1.0e9;
+	#else
+	return (double)clock() / CLOCKS_PER_SEC;
+	#endif
+}
+
+// *******************************************************************************************************************************
+//		Map the whole file into memory, or read it in where that isn't possible. Tapes are read once from start to end
+//		so the page cache does the streaming.
+// *******************************************************************************************************************************
+
+static int TAPEMap(TAPEFILE *file,const char *fileName) {
+	file->data = NULL;file->size = 0;file->isMapped = 0;
+	#ifdef LINUX
+	int fd = open(fileName,O_RDONLY);
+	if (fd < 0) return 0;
+	struct stat info;
+	if (fstat(fd,&info) == 0 && info.st_size > 0) {
+		void *map = mmap(NULL,info.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if (map != MAP_FAILED) {
+			madvise(map,info.st_size,MADV_SEQUENTIAL);
+			file->data = (BYTE8 *)map;file->size = info.st_size;file->isMapped = 1;
+		}
+	}
+	close(fd);
+	if (file->isMapped) return 1;
+	#endif
+	FILE *f = fopen(fileName,"rb");
+	if (f == NULL) return 0;
+	fseek(f,0,SEEK_END);file->size = ftell(f);fseek(f,0,SEEK_SET);
+	file->data = (BYTE8 *)malloc(file->size > 0 ? file->size : 1);
+	file->size = fread(file->data,1,file->size,f);
+	fclose(f);
+	return 1;
+}
+
+static void TAPEUnmap(TAPEFILE *file) {
+	if (file->data == NULL) return;
+	#ifdef LINUX
+	if (file->isMapped) munmap(file->data,file->size);
+	#endif
+	if (!file->isMapped) free(file->data);
+	file->data = NULL;file->size = 0;file->isMapped = 0;
+}
+
+// *******************************************************************************************************************************
+//		Find the format and data chunks. 8 bit unsigned or 16 bit signed PCM, any rate, the first channel is used.
+// *******************************************************************************************************************************
+
+#define WORD(p) 	((p)[0] | ((p)[1] << 8))
+#define LONG(p) 	((long)WORD(p) | ((long)WORD((p)+2) << 16))
+
+static int TAPEParse(TAPEDECODER *tape) {
+	const BYTE8 *image = tape->wav.data;
+	long imageSize = tape->wav.size;
+	if (imageSize < 12 || memcmp(image,"RIFF",4) != 0 || memcmp(image+8,"WAVE",4) != 0) return 0;
+	int isFormat = 0;
+	long offset = 12;
+	while (offset + 8 <= imageSize) {
+		const BYTE8 *chunk = image + offset;
+		long size = LONG(chunk+4);
+		if (memcmp(chunk,"fmt ",4) == 0 && size >= 16) {
+			int format = WORD(chunk+8);
+			if (format != 1 && format != 0xFFFE) return 0;							// PCM or extensible PCM
+			tape->sampleRate = LONG(chunk+12);
+			tape->frameSize = WORD(chunk+20);
+			tape->sampleBits = WORD(chunk+22);
+			isFormat = (tape->sampleBits == 8 || tape->sampleBits == 16) && tape->sampleRate >= 4800 && tape->frameSize > 0;
+		}
+		if (memcmp(chunk,"data",4) == 0 && isFormat) {
+			if (size > imageSize - offset - 8) size = imageSize - offset - 8;		// Truncated recording
+			tape->samples = chunk + 8;
+			tape->sampleCount = size / tape->frameSize;
+			return 1;
+		}
+		offset = offset + 8 + size + (size & 1);									// Chunks are word aligned
+	}
+	return 0;
+}
+
+// *******************************************************************************************************************************
+//		A half cycle of the tone from start to end. Longer than a 3600Hz half cycle is the 1200Hz tone, a 0 (space),
+//		otherwise 2400Hz, a 1 (mark). A character is a 0 start bit, 8 data bits low first and 1 stop bit (or more),
+//		each sampled in the middle.
+// *******************************************************************************************************************************
+
+static void TAPEHalfCycle(TAPEDECODER *tape,long start,long end) {
+	int isSpace = (end - start) * 3600 > tape->sampleRate;
+	if (!tape->inFrame) {
+		if (!isSpace) return;														// Waiting for a start bit.
+		tape->inFrame = 1;tape->bitNumber = 0;
+		tape->bitSample = start + tape->bitLength / 2;
+	}
+	while (tape->inFrame && tape->bitSample < end) {
+		int bit = !isSpace;
+		if (tape->bitNumber == 0) {													// Start bit, must still be 0
+			if (bit) tape->inFrame = 0;
+		} else if (tape->bitNumber <= 8) {
+			tape->shifter = (tape->shifter >> 1) | (bit << 7);
+		} else {																	// Stop bit, a 1 or it's garbage
+			if (bit && tape->pendingCount < (int)sizeof(tape->pending)) tape->pending[tape->pendingCount++] = tape->shifter;
+			tape->inFrame = 0;
+		}
+		tape->bitNumber++;
+		tape->bitSample += tape->bitLength;
+	}
+}
+
+// *******************************************************************************************************************************
+//		Demodulate a block. The samples are converted to 16 bit then to -1/0/+1 either side of a dead band, both simple
+//		loops over arrays the compiler vectorises. Then only changes of side are looked at, one per half cycle.
+// *******************************************************************************************************************************
+
+static void TAPEDecodeBlock(TAPEDECODER *tape) {
+	short wave[TAPE_BLOCK];
+	signed char side[TAPE_BLOCK];
+	int frameSize = tape->frameSize;
+	long position = tape->position;
+	int count = (tape->sampleCount - position < TAPE_BLOCK) ? (int)(tape->sampleCount - position) : TAPE_BLOCK;
+	const BYTE8 *p = tape->samples + position * frameSize;
+	if (tape->sampleBits == 8) {
+		for (int i = 0;i < count;i++) wave[i] = (short)((p[i*frameSize] - 128) << 8);
+	} else {
+		for (int i = 0;i < count;i++) wave[i] = (short)(p[i*frameSize] | (p[i*frameSize+1] << 8));
+	}
+	for (int i = 0;i < count;i++) {
+		side[i] = (signed char)((wave[i] > TAPE_HYSTERESIS) - (wave[i] < -TAPE_HYSTERESIS));
+	}
+	for (int i = 0;i < count;i++) {
+		if (side[i] != 0 && side[i] != tape->level) {								// Crossed zero
+			if (tape->level != 0) TAPEHalfCycle(tape,tape->lastCrossing,position+i);
+			tape->level = side[i];tape->lastCrossing = position+i;
+		}
+	}
+	tape->position += count;
+}
+
+// *******************************************************************************************************************************
+//		Decode into buffer until there is something to return, or the tape has ended. Returns the bytes copied.
+// *******************************************************************************************************************************
+
+static int TAPEDecode(TAPEDECODER *tape,BYTE8 *buffer,int size) {
+	if (tape->pendingPosition == tape->pendingCount && tape->position < tape->sampleCount) {
+		double start = TAPETime();
+		tape->pendingCount = tape->pendingPosition = 0;
+		while (tape->pendingCount == 0 && tape->position < tape->sampleCount) TAPEDecodeBlock(tape);
+		tape->decodeTime += TAPETime() - start;
+		tape->decoded += tape->pendingCount;
+	}
+	int n = tape->pendingCount - tape->pendingPosition;
+	if (n > size) n = size;
+	memcpy(buffer,tape->pending+tape->pendingPosition,n);
+	tape->pendingPosition += n;
+	return n;
+}
+
+static void TAPEReport(TAPEDECODER *tape) {
+	if (tape->isReported) return;
+	tape->isReported = 1;
+	double seconds = (double)tape->position / tape->sampleRate;
+	fprintf(stderr,"%s : %ld bytes from %.1fs of audio, decoded at %.0fx real time.\n",tape->name,tape->decoded,
+							seconds,(tape->decodeTime > 0) ? seconds / tape->decodeTime : 0.0);
+}
+
+// *******************************************************************************************************************************
+//								Open a recording ready to decode. Returns zero on failure.
+// *******************************************************************************************************************************
+
+static int TAPELoad(TAPEDECODER *tape,const char *fileName) {
+	memset(tape,0,sizeof(TAPEDECODER));
+	if (!TAPEMap(&tape->wav,fileName)) { perror(fileName);return 0; }
+	if (!TAPEParse(tape)) {
+		fprintf(stderr,"%s is not an 8 or 16 bit PCM WAV file.\n",fileName);
+		TAPEUnmap(&tape->wav);
+		return 0;
+	}
+	snprintf(tape->name,sizeof(tape->name),"%s",fileName);
+	tape->bitLength = (double)tape->sampleRate / TAPE_BAUD;
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//
+//		The cache. Decoded bytes are kept in the cache directory in a file named from a hash of the WAV file and the
+//		decoder settings, so changing either decodes again. The hash is four independent multiply/rotate lanes over
+//		8 byte words, much faster than decoding ; it detects changes, it is not cryptographic.
+//
+// *******************************************************************************************************************************
+
+#define ROTATE(x,n) 	(((x) << (n)) | ((x) >> (64-(n))))
+
+static unsigned long long TAPEHash(const BYTE8 *data,long size) {
+	const unsigned long long prime = 0x9E3779B185EBCA87ULL;
+	unsigned long long lane[4] = { TAPE_BAUD,TAPE_HYSTERESIS,TAPE_BLOCK,TAPE_CACHE_VERSION };
+	long i = 0;
+	for (;i + 32 <= size;i += 32) {
+		unsigned long long word[4];
+		memcpy(word,data+i,32);
+		for (int n = 0;n < 4;n++) lane[n] = ROTATE((lane[n] ^ word[n]) * prime,31);
+	}
+	unsigned long long hash = size;
+	for (int n = 0;n < 4;n++) hash = ROTATE((hash ^ lane[n]) * prime,27);
+	for (;i < size;i++) hash = (hash ^ data[i]) * prime;
+	hash ^= hash >> 33;hash *= prime;hash ^= hash >> 29;
+	return hash;
+}
+
+#define TAPE_CACHENAME 	(TAPE_MAXPATH+32)											// Room for directory/hash.kcs
+
+static int TAPECacheName(char *name,int size,const TAPEFILE *wav) {					// Zero if it doesn't fit.
+	return snprintf(name,size,"%s/%016llx.kcs",cacheDirectory,TAPEHash(wav->data,wav->size)) < size;
+}
+
+// *******************************************************************************************************************************
+//		Decode a whole recording into the cache, unless it is already there. Written to a temporary name and renamed
+//		so other jobs sharing the cache never see part of one. Returns zero on failure, fills in the cache name.
+// *******************************************************************************************************************************
+
+static int TAPECacheFile(const char *fileName,char *cacheName,int size,int isQuiet) {
+	TAPEDECODER *tape = (TAPEDECODER *)malloc(sizeof(TAPEDECODER));
+	if (!TAPELoad(tape,fileName)) { free(tape);return 0; }
+	if (!TAPECacheName(cacheName,size,&tape->wav)) {
+		fprintf(stderr,"Tape cache name too long for %s.\n",fileName);
+		TAPEUnmap(&tape->wav);free(tape);return 0;
+	}
+	FILE *f = fopen(cacheName,"rb");
+	if (f != NULL) {																// Already done.
+		fclose(f);
+		TAPEUnmap(&tape->wav);free(tape);
+		return 1;
+	}
+	char temporary[TAPE_CACHENAME+32];
+	static std::atomic<int> unique(0);
+	snprintf(temporary,sizeof(temporary),"%s.%d.%d",cacheName,(int)getpid(),unique++);
+	f = fopen(temporary,"wb");
+	if (f == NULL) { perror(temporary);TAPEUnmap(&tape->wav);free(tape);return 0; }
+	BYTE8 buffer[256];
+	int n;
+	while ((n = TAPEDecode(tape,buffer,sizeof(buffer))) > 0) fwrite(buffer,1,n,f);
+	fclose(f);
+	int isOk = (rename(temporary,cacheName) == 0);
+	if (!isOk) { perror(cacheName);remove(temporary); }
+	if (isOk && !isQuiet) TAPEReport(tape);
+	TAPEUnmap(&tape->wav);free(tape);
+	return isOk;
+}
+
+int TAPESetCache(const char *directory) {
+	if (strlen(directory) >= sizeof(cacheDirectory)) {
+		fprintf(stderr,"Tape cache directory name too long.\n");
+		return 0;
+	}
+	strcpy(cacheDirectory,directory);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//		Fill the cache for every .wav file in a directory, a thread per core each taking the next file. Returns the
+//		number that failed.
+// *******************************************************************************************************************************
+
+static char precacheFiles[TAPE_MAXFILES][TAPE_MAXPATH];
+static int precacheCount;
+static std::atomic<int> precacheNext,precacheFailed;
+
+static void TAPEPrecacheWorker(void) {
+	char cacheName[TAPE_CACHENAME];
+	int n;
+	while ((n = precacheNext++) < precacheCount) {
+		if (!TAPECacheFile(precacheFiles[n],cacheName,sizeof(cacheName),1)) precacheFailed++;
+	}
+}
+
+int TAPEPrecache(const char *directory) {
+	if (cacheDirectory[0] == '\0') { fprintf(stderr,"No tape cache directory given.\n");return 1; }
+	DIR *dir = opendir(directory);
+	if (dir == NULL) { perror(directory);return 1; }
+	struct dirent *entry;
+	precacheCount = 0;
+	int tooLong = 0;
+	while ((entry = readdir(dir)) != NULL && precacheCount < TAPE_MAXFILES) {
+		int n = strlen(entry->d_name);
+		if (n > 4 && strcasecmp(entry->d_name+n-4,".wav") == 0) {
+			if (snprintf(precacheFiles[precacheCount],TAPE_MAXPATH,"%s/%s",directory,entry->d_name) < TAPE_MAXPATH) {
+				precacheCount++;
+			} else {
+				fprintf(stderr,"Tape path too long for %s.\n",entry->d_name);
+				tooLong++;
+			}
+		}
+	}
+	closedir(dir);
+	precacheNext = 0;precacheFailed = tooLong;
+	int threadCount = std::thread::hardware_concurrency();
+	if (threadCount < 1) threadCount = 1;
+	if (threadCount > TAPE_MAXTHREADS) threadCount = TAPE_MAXTHREADS;
+	std::thread *threads[TAPE_MAXTHREADS];
+	double start = TAPETime();
+	for (int t = 0;t < threadCount;t++) threads[t] = new std::thread(TAPEPrecacheWorker);
+	for (int t = 0;t < threadCount;t++) {
+		threads[t]->join();
+		delete threads[t];
+	}
+	fprintf(stderr,"Cached %d tapes from %s in %.2fs using %d threads, %d failed.\n",precacheCount,directory,
+												TAPETime()-start,threadCount,(int)precacheFailed);
+	return precacheFailed;
+}
+
+// *******************************************************************************************************************************
+//		The ACIA source, from the cached bytes if there are some, otherwise decoding the recording as it goes.
+// *******************************************************************************************************************************
+
+static int TAPERead(BYTE8 *buffer,int size) {
+	if (cached.data != NULL) {
+		int n = (cached.size - cachedPosition < size) ? (int)(cached.size - cachedPosition) : size;
+		memcpy(buffer,cached.data+cachedPosition,n);
+		cachedPosition += n;
+		return n;
+	}
+	int n = TAPEDecode(&player,buffer,size);
+	if (n == 0 && player.position >= player.sampleCount) TAPEReport(&player);
+	return n;
+}
+
+// *******************************************************************************************************************************
+//								Open a recording and start playing it. Returns zero on failure.
+// *******************************************************************************************************************************
+
+int TAPEOpen(const char *fileName) {
+	TAPEUnmap(&player.wav);TAPEUnmap(&cached);
+	if (cacheDirectory[0] != '\0') {												// Decode to the cache and use that
+		char cacheName[TAPE_CACHENAME];
+		if (!TAPECacheFile(fileName,cacheName,sizeof(cacheName),0)) return 0;
+		if (!TAPEMap(&cached,cacheName)) { perror(cacheName);return 0; }
+		cachedPosition = 0;
+	} else {
+		if (!TAPELoad(&player,fileName)) return 0;
+	}
+	ACIASetSource(TAPERead);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//							Decode a whole recording to a file of bytes. Returns zero on failure.
+// *******************************************************************************************************************************
+
+int TAPEDecodeFile(const char *wavFile,const char *binaryFile) {
+	if (!TAPELoad(&player,wavFile)) return 0;
+	FILE *f = fopen(binaryFile,"wb");
+	if (f == NULL) { perror(binaryFile);TAPEUnmap(&player.wav);return 0; }
+	BYTE8 buffer[256];
+	int n;
+	while ((n = TAPEDecode(&player,buffer,sizeof(buffer))) > 0) fwrite(buffer,1,n,f);
+	fclose(f);
+	TAPEReport(&player);
+	TAPEUnmap(&player.wav);
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//
+//		Recording. Bytes the ACIA sends are collected in chunks which go through a queue to a writer thread, once a
+//		frame or when a chunk is full. The writer copies the precomputed waveform of each bit into the file, a 0
+//		start bit, 8 data bits and 2 stop bits as the ROMs use. The emulation only waits if the writer is a whole
+//		queue behind.
+//
+// *******************************************************************************************************************************
+
+typedef struct __TAPECHUNK {
+	BYTE8 data[256];
+	int count;
+} TAPECHUNK;
+
+static SPSCQueue<TAPECHUNK,TAPE_QUEUE> queue;
+static TAPECHUNK chunk;																// Chunk being filled.
+static std::thread *writer = NULL;													// NULL if not recording.
+static std::atomic<int> isClosing(0);
+static FILE *recordFile;
+static BYTE8 bitWave[2][TAPE_RATE/TAPE_BAUD*2];										// One bit of 1200Hz and 2400Hz
+static LONG32 recorded = 0,samplesWritten = 0;
+static int waits = 0;
+
+static void TAPEWriter(void);
+
+static void TAPEPush(void) {
+	if (chunk.count == 0) return;
+	while (!queue.push(chunk)) {													// Full, let the writer catch up.
+		waits++;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	chunk.count = 0;
+}
+
+static void TAPERecordByte(BYTE8 data) {											// The ACIA sink
+	chunk.data[chunk.count++] = data;
+	if (chunk.count == (int)sizeof(chunk.data)) TAPEPush();
+}
+
+// *******************************************************************************************************************************
+//		Start recording, 16 bit mono. Whole cycles fit in a bit at 300 baud so the tables join up without a step.
+// *******************************************************************************************************************************
+
+static void TAPEHeader(void) {
+	LONG32 dataSize = samplesWritten * 2;
+	BYTE8 header[44];
+	memcpy(header,"RIFF????WAVEfmt ????????????????????data????",44);
+	LONG32 values[] = { 36+dataSize,16,1|(1 << 16),TAPE_RATE,TAPE_RATE*2,2|(16 << 16),dataSize };
+	int offsets[] = { 4,16,20,24,28,32,40 };
+	for (int i = 0;i < 7;i++) {
+		for (int b = 0;b < 4;b++) header[offsets[i]+b] = (values[i] >> (b*8)) & 0xFF;
+	}
+	fwrite(header,1,sizeof(header),recordFile);
+}
+
+int TAPERecord(const char *fileName) {
+	recordFile = (strcmp(fileName,"-") == 0) ? stdout : fopen(fileName,"wb");
+	if (recordFile == NULL) { perror(fileName);return 0; }
+	setvbuf(recordFile,NULL,_IOFBF,1 << 20);
+	int n = TAPE_RATE/TAPE_BAUD;
+	for (int i = 0;i < n;i++) {
+		for (int bit = 0;bit < 2;bit++) {
+			int sample = (int)(TAPE_AMPLITUDE * sin(2.0 * M_PI * (bit ? 2400 : 1200) * i / TAPE_RATE));
+			bitWave[bit][i*2] = sample & 0xFF;bitWave[bit][i*2+1] = (sample >> 8) & 0xFF;
+		}
+	}
+	TAPEHeader();																	// Sizes filled in on close.
+	chunk.count = 0;
+	ACIASetSink(TAPERecordByte);
+	writer = new std::thread(TAPEWriter);
+	return 1;
+}
+
+void TAPESync(void) {																// End of frame, pass on the chunk
+	if (writer != NULL) TAPEPush();
+}
+
+// *******************************************************************************************************************************
+//										The writer thread, leader, bytes, trailer.
+// *******************************************************************************************************************************
+
+static void TAPEWriteBit(int bit) {
+	fwrite(bitWave[bit],1,sizeof(bitWave[bit]),recordFile);
+	samplesWritten += TAPE_RATE/TAPE_BAUD;
+}
+
+static void TAPEWriteTone(int seconds) {											// Mark tone between recordings
+	for (int i = 0;i < seconds * TAPE_BAUD;i++) TAPEWriteBit(1);
+}
+
+static void TAPEWriter(void) {
+	TAPECHUNK item;
+	TAPEWriteTone(TAPE_LEADER);
+	while (1) {
+		if (!queue.pop(item)) {
+			if (isClosing) break;													// Empty and finished.
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			continue;
+		}
+		for (int i = 0;i < item.count;i++) {
+			TAPEWriteBit(0);
+			for (int b = 0;b < 8;b++) TAPEWriteBit((item.data[i] >> b) & 1);
+			TAPEWriteBit(1);TAPEWriteBit(1);
+		}
+		recorded += item.count;
+	}
+	TAPEWriteTone(1);
+}
+
+// *******************************************************************************************************************************
+//								Stop playing and recording, a recording has its sizes fixed
+// *******************************************************************************************************************************
+
+void TAPEClose(void) {
+	if (player.wav.data != NULL && player.decoded != 0) TAPEReport(&player);
+	TAPEUnmap(&player.wav);TAPEUnmap(&cached);
+	if (writer == NULL) return;
+	TAPEPush();
+	isClosing = 1;
+	writer->join();
+	delete writer;
+	writer = NULL;
+	if (recordFile != stdout) {
+		fseek(recordFile,0,SEEK_SET);
+		TAPEHeader();
+		fclose(recordFile);
+	} else {
+		fflush(stdout);
+	}
+	fprintf(stderr,"Recorded %u bytes, %.1fs of tape, the emulation waited %d times.\n",recorded,
+										(double)samplesWritten / TAPE_RATE,waits);
+}
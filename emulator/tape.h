@@ -0,0 +1,37 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		tape.h
+//		Purpose:	Kansas City Standard cassette recordings (WAV) decoded for the ACIA, and made from what it sends (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _TAPE_H
+#define _TAPE_H
+
+#define TAPE_BAUD 		(300)														// 4 x 1200Hz is 0, 8 x 2400Hz is 1
+#define TAPE_BLOCK 		(4096)														// Samples demodulated at a time
+#define TAPE_HYSTERESIS (512)														// Zero crossing dead band (16 bit)
+
+#define TAPE_CACHE_VERSION (1)														// Change if decoding changes
+#define TAPE_MAXFILES 	(4096)														// Tapes in a directory to cache
+#define TAPE_MAXTHREADS (64)
+#define TAPE_MAXPATH 	(512)														// Longest directory or tape path
+
+#define TAPE_RATE 		(44100)														// Recordings made, 16 bit mono
+#define TAPE_AMPLITUDE 	(24000)
+#define TAPE_LEADER 	(2)															// Seconds of mark tone first
+#define TAPE_QUEUE 		(1024)														// Chunks waiting to be written
+
+int  TAPEOpen(const char *fileName);
+int  TAPEDecodeFile(const char *wavFile,const char *binaryFile);
+int  TAPESetCache(const char *directory);
+int  TAPEPrecache(const char *directory);
+int  TAPERecord(const char *fileName);
+void TAPESync(void);
+void TAPEClose(void);
+
+#endif
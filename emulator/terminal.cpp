@@ -0,0 +1,225 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		terminal.cpp
+//		Purpose:	Text front end, runs the emulator in an ANSI terminal (e.g. over SSH) without SDL.
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <poll.h>
+
+#include "sys_processor.h"
+#include "hardware.h"
+#include "video.h"
+#include "host.h"
+#include "console.h"
+#include "batch.h"
+
+#include "character_rom.inc"
+
+#define TTY_X 		(2)																// Top left of display on terminal
+#define TTY_Y 		(2)
+
+static struct termios original;														// Terminal settings to restore.
+static char glyphs[256][8];															// UTF-8 for each character code.
+static BYTE8 shown[1024];															// What is on the terminal now.
+
+static char output[65536];															// Output built up for a frame.
+static int outputSize = 0;
+
+// *******************************************************************************************************************************
+//		Unicode for each character. ASCII where the ROM matches it, otherwise the nearest quadrant block character, a
+//		quadrant being lit if a quarter of its 4x4 pixels are.
+// *******************************************************************************************************************************
+
+static const char *quadrants[16] = {
+	" ","▘","▝","▀","▖","▌","▞","▛",
+	"▗","▚","▐","▜","▄","▙","▟","█"
+};
+
+static void TTYBuildGlyphs(void) {
+	for (int ch = 0;ch < 256;ch++) {
+		if (ch >= 0x20 && ch < 0x7F) {												// Mostly ASCII
+			glyphs[ch][0] = ch;glyphs[ch][1] = '\0';
+		} else {
+			int lit[4] = { 0,0,0,0 };
+			for (int y = 0;y < 8;y++) {
+				for (int x = 0;x < 8;x++) {
+					if (character_rom[ch*8+y] & (0x80 >> x)) lit[(x >> 2) + (y >> 2) * 2]++;
+				}
+			}
+			int q = 0;
+			for (int i = 0;i < 4;i++) if (lit[i] >= 4) q |= (1 << i);
+			strcpy(glyphs[ch],quadrants[q]);
+		}
+	}
+	strcpy(glyphs[0x5E],"↑");													// Where the ROM differs from ASCII
+	strcpy(glyphs[0x60]," ");
+	strcpy(glyphs[0x7C],"}");
+	strcpy(glyphs[0x7D],"¦");
+	strcpy(glyphs[0x7E],"÷");
+}
+
+// *******************************************************************************************************************************
+//												Buffered output to the terminal
+// *******************************************************************************************************************************
+
+static void TTYFlush(void) {
+	int done = 0;
+	while (done < outputSize) {
+		int n = write(STDOUT_FILENO,output+done,outputSize-done);
+		if (n <= 0) break;
+		done += n;
+	}
+	outputSize = 0;
+}
+
+static void TTYWrite(const char *s) {
+	int n = strlen(s);
+	if (outputSize + n > (int)sizeof(output)) TTYFlush();
+	memcpy(output+outputSize,s,n);
+	outputSize += n;
+}
+
+// *******************************************************************************************************************************
+//		Draw the cells that changed. Each run of changed cells on a line is one cursor move then the characters.
+// *******************************************************************************************************************************
+
+static void TTYRender(const BYTE8 *video,const BYTE8 *changed,int isFull) {
+	char buffer[32];
+	for (int y = 0;y < VID_ROWS;y++) {
+		int inRun = 0;
+		for (int x = 0;x < VID_COLUMNS;x++) {
+			int offset = VID_OFFSET + x + y * VID_STRIDE;
+			int isChanged = isFull || ((changed[offset >> 3] & (1 << (offset & 7))) && shown[offset] != video[offset]);
+			if (isChanged) {
+				if (!inRun) {
+					sprintf(buffer,"\x1b[%d;%dH",TTY_Y+y,TTY_X+x);
+					TTYWrite(buffer);
+					inRun = 1;
+				}
+				TTYWrite(glyphs[video[offset]]);
+				shown[offset] = video[offset];
+			} else {
+				inRun = 0;
+			}
+		}
+	}
+	TTYFlush();
+}
+
+static void TTYFrame(void) {
+	char buffer[32];
+	TTYWrite("\x1b[2J");															// Clear and draw a frame
+	sprintf(buffer,"\x1b[%d;%dH+",TTY_Y-1,TTY_X-1);TTYWrite(buffer);
+	for (int x = 0;x < VID_COLUMNS;x++) TTYWrite("-");
+	TTYWrite("+");
+	for (int y = 0;y < VID_ROWS;y++) {
+		sprintf(buffer,"\x1b[%d;%dH|",TTY_Y+y,TTY_X-1);TTYWrite(buffer);
+		sprintf(buffer,"\x1b[%d;%dH|",TTY_Y+y,TTY_X+VID_COLUMNS);TTYWrite(buffer);
+	}
+	sprintf(buffer,"\x1b[%d;%dH+",TTY_Y+VID_ROWS,TTY_X-1);TTYWrite(buffer);
+	for (int x = 0;x < VID_COLUMNS;x++) TTYWrite("-");
+	TTYWrite("+");
+}
+
+// *******************************************************************************************************************************
+//								Raw, non blocking keyboard. Restored however we exit.
+// *******************************************************************************************************************************
+
+static void TTYRestore(void) {
+	char buffer[32];
+	sprintf(buffer,"\x1b[%d;1H\x1b[?25h\n",TTY_Y+VID_ROWS+1);						// Below the display, cursor on.
+	TTYWrite(buffer);
+	TTYFlush();
+	tcsetattr(STDIN_FILENO,TCSAFLUSH,&original);
+}
+
+static void TTYOpen(void) {
+	if (tcgetattr(STDIN_FILENO,&original) == 0) {
+		struct termios raw = original;
+		raw.c_iflag &= ~(ICRNL|IXON|BRKINT|ISTRIP|INPCK);
+		raw.c_lflag &= ~(ECHO|ICANON|ISIG|IEXTEN);
+		raw.c_cc[VMIN] = 0;raw.c_cc[VTIME] = 0;										// Reads return immediately.
+		tcsetattr(STDIN_FILENO,TCSAFLUSH,&raw);
+		atexit(TTYRestore);
+	}
+	TTYWrite("\x1b[?25l");															// Cursor off.
+	TTYFrame();
+}
+
+// *******************************************************************************************************************************
+//		Read what has been typed and auto type it. Returns zero if ESC was pressed on its own (cursor keys etc. send ESC
+//		sequences, these are ignored)
+// *******************************************************************************************************************************
+
+static int TTYReadKeys(void) {
+	BYTE8 buffer[64];
+	if (CONUsingStdin()) return 1;													// Stdin is being read as input.
+	struct pollfd input = { STDIN_FILENO,POLLIN,0 };								// (stdin may not be a terminal)
+	if (poll(&input,1,0) <= 0 || (input.revents & POLLIN) == 0) return 1;
+	int n = read(STDIN_FILENO,buffer,sizeof(buffer));
+	for (int i = 0;i < n;i++) {
+		if (buffer[i] == 0x1B) {
+			if (i == n-1) return 0;													// ESC on its own, exit.
+			i++;																	// Skip ESC [ or ESC O
+			while (i < n-1 && !((buffer[i] >= 'A' && buffer[i] <= 'Z') || buffer[i] == '~' ||
+									(buffer[i] >= 'a' && buffer[i] <= 'z'))) i++;
+			continue;
+		}
+		if (buffer[i] == '\n' && i > 0 && buffer[i-1] == '\r') continue;			// CR LF is one return.
+		char text[2] = { (char)buffer[i],'\0' };
+		HWTypeText(text);															// Typed as the guest scans.
+	}
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//													Main program
+// *******************************************************************************************************************************
+
+int main(int argc,char *argv[]) {
+	static CPUSNAPSHOT snapshot;
+	CPUReset();
+	for (int i = 1;i < argc;i++) {
+		if ((strcmp(argv[i],"-capture") == 0 || strcmp(argv[i],"-output") == 0) &&		// stdout is the display here.
+								i+1 < argc && strcmp(argv[i+1],"-") == 0) {
+			fprintf(stderr,"%s can't write to stdout in the terminal version, give a file name.\n",argv[i]);
+			return 1;
+		}
+		int used = HOSTOption(argc,argv,i);											// Options common to all front ends.
+		if (used != 0) {
+			i += used-1;
+		} else {
+			CPULoadBinary(argv[i]);													// Optional memory image.
+		}
+	}
+	if (BATIsEnabled()) return BATRun();											// No display, as fast as possible.
+	TTYBuildGlyphs();
+	TTYOpen();
+	int isFull = 1;
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC,&next);
+	while (TTYReadKeys() && !CPUHasExited()) {
+		int frameRate;
+		while ((frameRate = CPUExecuteInstruction()) == 0) {}						// Run one frame.
+		CPUGetSnapshot(&snapshot,0);
+		TTYRender(snapshot.video,snapshot.changed,isFull);
+		isFull = 0;
+		next.tv_nsec += 1000000000L / frameRate;									// Wait for the next frame.
+		if (next.tv_nsec >= 1000000000L) { next.tv_nsec -= 1000000000L;next.tv_sec++; }
+		clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&next,NULL);
+	}
+	CPUEndRun();
+	HOSTEnd();
+	return 0;
+}
@@ -0,0 +1,113 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		video.cpp
+//		Purpose:	Software rendering of the UK101 display into 32 bit pixels
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#include <string.h>
+#include "sys_processor.h"
+#include "video.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "character_rom.inc"
+
+#define MAXSCALE 	(8)																// Largest supported scale.
+
+// *******************************************************************************************************************************
+//
+//		For each scale, the character ROM bit tested by each pixel of an expanded row, e.g. at scale 2 this is
+//		$80,$80,$40,$40 ... $01,$01. Built once, on first use.
+//
+// *******************************************************************************************************************************
+
+static LONG32 laneBits[MAXSCALE+1][8*MAXSCALE];
+
+static int VIDInitialiseLanes(void) {
+	for (int scale = 1;scale <= MAXSCALE;scale++) {
+		for (int i = 0;i < 8*scale;i++) laneBits[scale][i] = 0x80 >> (i / scale);
+	}
+	return 1;
+}
+
+// *******************************************************************************************************************************
+//
+//		Expand one 8 bit row into width pixels. Each lane is masked against its bit, compared to get all ones or all
+//		zeros, then used to blend the foreground and background. Width is always a multiple of 8.
+//
+// *******************************************************************************************************************************
+
+static void VIDExpandRow(LONG32 *target,int bits,int width,const LONG32 *lanes,LONG32 foreground,LONG32 background) {
+	#if defined(__AVX2__)
+	__m256i b = _mm256_set1_epi32(bits);
+	__m256i f = _mm256_set1_epi32(foreground);
+	__m256i g = _mm256_set1_epi32(background);
+	for (int i = 0;i < width;i += 8) {
+		__m256i m = _mm256_loadu_si256((const __m256i *)(lanes+i));
+		__m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(b,m),m);
+		_mm256_storeu_si256((__m256i *)(target+i),_mm256_or_si256(_mm256_and_si256(mask,f),_mm256_andnot_si256(mask,g)));
+	}
+	#elif defined(__SSE2__)
+	__m128i b = _mm_set1_epi32(bits);
+	__m128i f = _mm_set1_epi32(foreground);
+	__m128i g = _mm_set1_epi32(background);
+	for (int i = 0;i < width;i += 4) {
+		__m128i m = _mm_loadu_si128((const __m128i *)(lanes+i));
+		__m128i mask = _mm_cmpeq_epi32(_mm_and_si128(b,m),m);
+		_mm_storeu_si128((__m128i *)(target+i),_mm_or_si128(_mm_and_si128(mask,f),_mm_andnot_si128(mask,g)));
+	}
+	#else
+	for (int i = 0;i < width;i++) {
+		target[i] = (bits & lanes[i]) ? foreground : background;
+	}
+	#endif
+}
+
+// *******************************************************************************************************************************
+//
+//		Draw one character, 8 x scale wide and 16 x scale high as each ROM row is doubled vertically. Pitch is in pixels.
+//
+// *******************************************************************************************************************************
+
+void VIDDrawCharacter(LONG32 *pixels,int pitch,int ch,int scale,LONG32 foreground,LONG32 background) {
+	static int isInitialised = VIDInitialiseLanes();								// (Thread safe first time)
+	(void)isInitialised;
+	if (scale < 1) scale = 1;
+	if (scale > MAXSCALE) scale = MAXSCALE;
+	const BYTE8 *pattern = character_rom + (ch & 0xFF) * 8;
+	int width = 8 * scale;
+	for (int y = 0;y < 8;y++) {
+		LONG32 *line = pixels + y * 2 * scale * pitch;
+		VIDExpandRow(line,pattern[y],width,laneBits[scale],foreground,background);
+		for (int r = 1;r < 2 * scale;r++) {											// Copy it to the repeated rows.
+			memcpy(line + r * pitch,line,width * sizeof(LONG32));
+		}
+	}
+}
+
+// *******************************************************************************************************************************
+//
+//		Draw the visible 48x16 area of video RAM ($D000-$D3FF). If changed is not NULL only draw the bytes whose
+//		bits are set in it.
+//
+// *******************************************************************************************************************************
+
+void VIDDrawScreen(const BYTE8 *video,const BYTE8 *changed,LONG32 *pixels,int pitch,int scale,
+																		LONG32 foreground,LONG32 background) {
+	for (int y = 0;y < VID_ROWS;y++) {
+		for (int x = 0;x < VID_COLUMNS;x++) {
+			int offset = VID_OFFSET + x + y * VID_STRIDE;
+			if (changed == NULL || (changed[offset >> 3] & (1 << (offset & 7)))) {
+				VIDDrawCharacter(pixels + y * 16 * scale * pitch + x * 8 * scale,pitch,video[offset],
+																		scale,foreground,background);
+			}
+		}
+	}
+}
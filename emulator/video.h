@@ -0,0 +1,27 @@
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+//
+//		Name:		video.h
+//		Purpose:	Software rendering of the UK101 display (Header)
+//		Created:	18th October 2026
+//		Author:		Paul Robson (paul@robsons.org.uk)
+//
+// *******************************************************************************************************************************
+// *******************************************************************************************************************************
+
+#ifndef _VIDEO_H
+#define _VIDEO_H
+
+#define VID_COLUMNS 	(48)														// Visible characters across
+#define VID_ROWS 		(16)														// Visible lines down
+#define VID_OFFSET 		(0x00C)														// Offset of first visible character
+#define VID_STRIDE 		(64)														// Bytes per line in video RAM
+
+#define VID_WIDTH 		(VID_COLUMNS*8)												// Display size at scale 1.
+#define VID_HEIGHT 		(VID_ROWS*16)
+
+void VIDDrawCharacter(LONG32 *pixels,int pitch,int ch,int scale,LONG32 foreground,LONG32 background);
+void VIDDrawScreen(const BYTE8 *video,const BYTE8 *changed,LONG32 *pixels,int pitch,int scale,
+																		LONG32 foreground,LONG32 background);
+
+#endif
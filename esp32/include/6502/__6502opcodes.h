@@ -112,6 +112,8 @@ case 0x40: /* $40 rti */
 	Cycles(6);explodeFlagRegister(Pop());pc = Pop();pc = pc | (((WORD16)Pop()) << 8);break;
 case 0x41: /* $41 eor (@1,x) */
 	Cycles(7);temp8 = (Fetch()+x) & 0xFF;eac = ReadWord01(temp8);sValue = zValue = a = a ^ Read(eac);break;
+case 0x42: /* $42 hcall */
+	Cycles(2);CPUHypercall();break;
 case 0x45: /* $45 eor @1 */
 	Cycles(3);eac = Fetch();sValue = zValue = a = a ^ Read01(eac);break;
 case 0x46: /* $46 lsr @1 */
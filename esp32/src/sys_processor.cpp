@@ -10,9 +10,14 @@
 // *******************************************************************************************************************************
 
 #include <stdio.h>
+#include <string.h>
 #include "sys_processor.h"
 #include "sys_debug_system.h"
 #include "hardware.h"
+#ifdef INCLUDE_DEBUGGING_SUPPORT
+#include "acia.h"
+#define ENABLE_IRQ																	// The ACIA can interrupt.
+#endif
 
 // *******************************************************************************************************************************
 //														   Timing
@@ -32,6 +37,7 @@ static BYTE8 carryFlag,interruptDisableFlag,breakFlag,								// Values represen
 static WORD16 pc;																	// Program Counter.
 static BYTE8 ramMemory[RAMSIZE];													// Memory at $0000 upwards
 static LONG32 cycles;																// Cycle Count.
+static LONG32 frameCount;															// Frames completed.
 
 // *******************************************************************************************************************************
 //											 Memory and I/O read and write macros.
@@ -61,9 +67,19 @@ static inline void _Write(WORD16 address,BYTE8 data);								// used in support
 // *******************************************************************************************************************************
 
 static inline BYTE8 _Read(WORD16 address) {
+	#ifdef INCLUDE_DEBUGGING_SUPPORT
+	if ((address & 0xFFFE) == ACIA_BASE && ACIAIsEnabled()) return ACIARead(address);
+	#endif
 	return ramMemory[address];							
 }
 
+static inline BYTE8 _Peek(WORD16 address) {											// Read with no side effects, for
+	#ifdef INCLUDE_DEBUGGING_SUPPORT												// the host rather than the CPU.
+	if ((address & 0xFFFE) == ACIA_BASE && ACIAIsEnabled()) return ACIAPeek(address);
+	#endif
+	return ramMemory[address];
+}
+
 static inline void _Write(WORD16 address,BYTE8 data) {
 	if (address < 0x8000) {
 		ramMemory[address] = data;
@@ -79,6 +95,9 @@ static inline void _Write(WORD16 address,BYTE8 data) {
 	if (address == 0xDF00) {
 		ramMemory[0xDF00] = HWWriteKeyboard(data);
 	}
+	#ifdef INCLUDE_DEBUGGING_SUPPORT
+	if ((address & 0xFFFE) == ACIA_BASE && ACIAIsEnabled()) ACIAWrite(address,data);
+	#endif
 }
 
 // *******************************************************************************************************************************
@@ -90,6 +109,18 @@ static inline void _Write(WORD16 address,BYTE8 data) {
 
 #ifdef INCLUDE_DEBUGGING_SUPPORT
 static void CPULoadChunk(FILE *f,BYTE8* memory,int count);
+
+#define MAXTRAPS 	(32)															// Addresses with host code.
+
+static BYTE8 trapMap[0x10000/8];													// Bit set for each trapped address
+static int trapCount = 0;
+static WORD16 trapAddress[MAXTRAPS];
+static CPUTRAPHANDLER trapHandler[MAXTRAPS];
+static int CPUCallTrap(void);
+static void CPUHypercall(void);
+static CPUINTERRUPT interruptSource = NULL;
+#else
+static void CPUHypercall(void) { carryFlag = 1; }									// No host services, fails.
 #endif
 
 #ifdef ESP32
@@ -121,15 +152,28 @@ void CPUReset(void) {
 //												Execute a single instruction
 // *******************************************************************************************************************************
 
+static inline BYTE8 CPUEndInstruction(void) {										// Interrupts, end of frame.
+	#ifdef INCLUDE_DEBUGGING_SUPPORT
+	if (interruptSource != NULL && (*interruptSource)()) irqCode();					// IRQ line held low ?
+	#endif
+	if (cycles < CYCLES_PER_FRAME) return 0;										// Not completed a frame.
+	cycles = cycles - CYCLES_PER_FRAME;												// Adjust this frame rate.
+	frameCount++;
+	HWSync();																		// Update any hardware
+	return FRAME_RATE;																// Return frame rate.
+}
+
 BYTE8 CPUExecuteInstruction(void) {
+	#ifdef INCLUDE_DEBUGGING_SUPPORT
+	if (trapCount != 0 && (trapMap[pc >> 3] & (1 << (pc & 7)))) {					// Host code to run here first ?
+		if (CPUCallTrap()) return CPUEndInstruction();								// If it went elsewhere, that was
+	}																				// the instruction.
+	#endif
 	BYTE8 opcode = Fetch();															// Fetch opcode.
 	switch(opcode) {																// Execute it.
 		#include "6502/__6502opcodes.h"
 	}
-	if (cycles < CYCLES_PER_FRAME) return 0;										// Not completed a frame.
-	cycles = cycles - CYCLES_PER_FRAME;												// Adjust this frame rate.
-	HWSync();																		// Update any hardware
-	return FRAME_RATE;																// Return frame rate.
+	return CPUEndInstruction();
 }
 
 // *******************************************************************************************************************************
@@ -137,7 +181,7 @@ BYTE8 CPUExecuteInstruction(void) {
 // *******************************************************************************************************************************
 
 BYTE8 CPUReadMemory(WORD16 address) {
-	return Read(address);
+	return _Peek(address);
 }
 
 void CPUWriteMemory(WORD16 address,BYTE8 data) {
@@ -147,7 +191,9 @@ void CPUWriteMemory(WORD16 address,BYTE8 data) {
 
 #ifdef INCLUDE_DEBUGGING_SUPPORT
 
+#ifndef HEADLESS
 #include "gfx.h"
+#endif
 
 // *******************************************************************************************************************************
 //		Execute chunk of code, to either of two break points or frame-out, return non-zero frame rate on frame, breakpoint 0
@@ -179,8 +225,17 @@ void CPUEndRun(void) {
 	fclose(f);
 }
 
+static int hasExited = 0;															// Set when the program stops the machine
+
 void CPUExit(void) {	
+	hasExited = 1;
+	#ifndef HEADLESS
 	GFXExit();
+	#endif
+}
+
+int CPUHasExited(void) {
+	return hasExited;
 }
 
 static void CPULoadChunk(FILE *f,BYTE8* memory,int count) {
@@ -215,4 +270,117 @@ CPUSTATUS *CPUGetStatus(void) {
 	return &st;
 }
 
+// *******************************************************************************************************************************
+//		Traps : host code run when the processor is about to execute an instruction at an address. The handler gets the
+//		registers, which it can change, and returns CPUTRAP_CONTINUE (run the instruction), CPUTRAP_RTS (return from
+//		the subroutine instead) or CPUTRAP_JUMP (continue at the handler's pc). Going elsewhere counts as the
+//		instruction, so breakpoints and traps at the new pc are seen. A NULL handler removes the trap.
+// *******************************************************************************************************************************
+
+void CPUSetTrap(WORD16 address,CPUTRAPHANDLER handler) {
+	int n = 0;
+	while (n < trapCount && trapAddress[n] != address) n++;
+	if (handler == NULL) {															// Remove it.
+		if (n == trapCount) return;
+		trapCount--;
+		trapAddress[n] = trapAddress[trapCount];trapHandler[n] = trapHandler[trapCount];
+		trapMap[address >> 3] &= ~(1 << (address & 7));
+		return;
+	}
+	if (n == MAXTRAPS) return;
+	if (n == trapCount) trapCount++;
+	trapAddress[n] = address;trapHandler[n] = handler;
+	trapMap[address >> 3] |= (1 << (address & 7));
+}
+
+static void CPUSetRegisters(CPUSTATUS *st) {										// Copy registers back after host code.
+	a = st->a;x = st->x;y = st->y;s = st->sp;pc = st->pc;
+	carryFlag = (st->carry != 0);zValue = (st->zero == 0);sValue = st->sign ? 0x80 : 0x00;
+	overflowFlag = (st->overflow != 0);decimalFlag = (st->decimal != 0);
+	interruptDisableFlag = (st->interruptDisable != 0);
+	cycles = st->cycles;
+}
+
+static int CPUCallTrap(void) {														// Non-zero if pc was changed.
+	int n = 0;
+	while (trapAddress[n] != pc) n++;
+	CPUSTATUS *st = CPUGetStatus();
+	int action = (*trapHandler[n])(st);
+	CPUSetRegisters(st);															// Any changes apply whatever it returns.
+	if (action == CPUTRAP_RTS) {													// Pull the return address.
+		s = (s + 1) & 0xFF;pc = Read01(0x100+s);
+		s = (s + 1) & 0xFF;pc = pc | (Read01(0x100+s) << 8);
+		pc = pc + 1;
+		Cycles(6);
+	}
+	return action != CPUTRAP_CONTINUE || pc != trapAddress[n];
+}
+
+// *******************************************************************************************************************************
+//		Hypercall : opcode $42 calls the host with the registers, which it can change. Without a handler carry is set.
+// *******************************************************************************************************************************
+
+static CPUHYPERCALL hypercallHandler = NULL;
+
+void CPUSetHypercall(CPUHYPERCALL handler) {
+	hypercallHandler = handler;
+}
+
+static void CPUHypercall(void) {
+	if (hypercallHandler == NULL) { carryFlag = 1;return; }
+	CPUSTATUS *st = CPUGetStatus();
+	(*hypercallHandler)(st);
+	CPUSetRegisters(st);
+}
+
+// *******************************************************************************************************************************
+//		Interrupts : the source is called after every instruction and returns non-zero while it is holding IRQ low.
+//		The clock is cycles since the machine started, for timing devices.
+// *******************************************************************************************************************************
+
+void CPUSetInterruptSource(CPUINTERRUPT source) {
+	interruptSource = source;
+}
+
+LONG32 CPUGetClock(void) {
+	return frameCount * CYCLES_PER_FRAME + cycles;
+}
+
+// *******************************************************************************************************************************
+//		Block copy and fill for host code. The same as writing each byte in turn, copying upwards, but video RAM is
+//		changed with one memmove/memset and one display notification rather than a byte at a time.
+// *******************************************************************************************************************************
+
+#define ISVIDEO(a) 	((a) >= 0xD000 && (a) <= 0xD400)									// As _Write()
+
+void CPUCopyMemory(WORD16 to,WORD16 from,int count) {
+	if (ISVIDEO(to) && ISVIDEO(to+count-1) && (to <= from || to >= from+count) && from+count <= RAMSIZE) {
+		memmove(ramMemory+to,ramMemory+from,count);
+		HWWriteDisplayRange(to,count);
+		return;
+	}
+	for (int i = 0;i < count;i++) _Write((to+i) & 0xFFFF,_Peek((from+i) & 0xFFFF));
+}
+
+void CPUFillMemory(WORD16 to,BYTE8 data,int count) {
+	if (ISVIDEO(to) && ISVIDEO(to+count-1)) {
+		memset(ramMemory+to,data,count);
+		HWWriteDisplayRange(to,count);
+		return;
+	}
+	for (int i = 0;i < count;i++) _Write((to+i) & 0xFFFF,data);
+}
+
+// *******************************************************************************************************************************
+//		Snapshot of the processor and video RAM, published once a frame to the renderer. If merge is set the snapshot
+//		being replaced was never displayed, so its changed cells are kept.
+// *******************************************************************************************************************************
+
+void CPUGetSnapshot(CPUSNAPSHOT *snapshot,int merge) {
+	snapshot->status = *CPUGetStatus();
+	for (int i = 0;i < 1024;i++) snapshot->video[i] = ramMemory[0xD000+i];
+	HWGetDisplayChanges(snapshot->changed,merge);
+	snapshot->frame = frameCount;
+}
+
 #endif